@@ -32,9 +32,11 @@ namespace bb {
  * Reserves specified size in internal vector
  *
  * @param size Size (in bytes) of space to preallocate internally. Default is set in BB_DEFAULT_SIZE
+ * @param mr Memory resource all of the buffer's storage is allocated from. Must outlive the buffer and any of its clones.
+ *           Default is the current std::pmr default resource (new/delete unless changed)
  */
-ByteBuffer::ByteBuffer(uint32_t size) {
-    buf.reserve(size);
+ByteBuffer::ByteBuffer(bb_size_t size, std::pmr::memory_resource* mr) : resource(mr), store(newStorage()) {
+    store->reserve(size);
     clear();
 }
 
@@ -44,26 +46,68 @@ ByteBuffer::ByteBuffer(uint32_t size) {
  *
  * @param arr byte array of data (should be of length len)
  * @param size Size of space to allocate
+ * @param mr Memory resource all of the buffer's storage is allocated from. Must outlive the buffer and any of its clones
  */
-ByteBuffer::ByteBuffer(const uint8_t* arr, uint32_t size) {
+ByteBuffer::ByteBuffer(const uint8_t* arr, bb_size_t size, std::pmr::memory_resource* mr) : resource(mr), store(newStorage()) {
     // If the provided array is NULL, allocate a blank buffer of the provided size
     if (arr == nullptr) {
-        buf.reserve(size);
+        store->reserve(size);
         clear();
     } else { // Consume the provided array
-        buf.reserve(size);
+        store->reserve(size);
         clear();
         putBytes(arr, size);
     }
 }
 
+/**
+ * ByteBuffer move constructor
+ * Take over the backing bytes and state of other. other is left empty but usable
+ *
+ * @param other ByteBuffer to move from
+ */
+ByteBuffer::ByteBuffer(ByteBuffer&& other) noexcept
+    : resource(other.resource), store(std::move(other.store)), base(other.base), off(other.off), limit(other.limit), rpos(other.rpos), wpos(other.wpos),
+      markPos(other.markPos), failed(other.failed)
+#ifdef BB_UTILITY
+    , name(std::move(other.name))
+#endif
+{
+    other.base = nullptr;
+    other.off = other.limit = other.rpos = other.wpos = other.markPos = 0;
+    other.failed = false;
+}
+
+ByteBuffer& ByteBuffer::operator=(ByteBuffer&& other) noexcept {
+    if (this == &other)
+        return *this;
+
+    resource = other.resource;
+    store = std::move(other.store);
+    base = other.base;
+    off = other.off;
+    limit = other.limit;
+    rpos = other.rpos;
+    wpos = other.wpos;
+    markPos = other.markPos;
+    failed = other.failed;
+#ifdef BB_UTILITY
+    name = std::move(other.name);
+#endif
+
+    other.base = nullptr;
+    other.off = other.limit = other.rpos = other.wpos = other.markPos = 0;
+    other.failed = false;
+    return *this;
+}
+
 /**
  * Bytes Remaining
  * Returns the number of bytes from the current read position till the end of the buffer
  *
  * @return Number of bytes from rpos to the end (size())
  */
-uint32_t ByteBuffer::bytesRemaining() const {
+bb_size_t ByteBuffer::bytesRemaining() const {
     return rpos >= size() ? 0 : size() - rpos;
 }
 
@@ -74,33 +118,77 @@ uint32_t ByteBuffer::bytesRemaining() const {
 void ByteBuffer::clear() {
     rpos = 0;
     wpos = 0;
-    buf.clear();
+    markPos = 0;
+    limit = 0;
+    failed = false;
+
+    // Other buffers may still be reading the shared bytes, so start over with fresh storage instead
+    if (off != 0 || store.use_count() != 1)
+        store = newStorage();
+    store->clear();
+    off = 0;
+    base = store->data();
 }
 
 /**
  * Clone
- * Allocate an exact copy of the ByteBuffer on the heap and return a pointer
+ * Allocate a ByteBuffer on the heap with the exact same contents and state (rpos, wpos) and return a pointer.
+ * O(1): the clone shares the backing bytes until either buffer writes
  *
- * @return A pointer to the newly cloned ByteBuffer. NULL if no more memory available
+ * @return A pointer to the newly cloned ByteBuffer
  */
-std::unique_ptr<ByteBuffer> ByteBuffer::clone() {
-    auto ret = std::make_unique<ByteBuffer>(buf.size());
-
-    // Copy data
-    for (uint32_t i = 0; i < buf.size(); i++) {
-        ret->put(get(i));
-    }
+std::unique_ptr<ByteBuffer> ByteBuffer::clone() const {
+    return std::make_unique<ByteBuffer>(*this);
+}
 
-    // Reset positions
-    ret->setReadPos(0);
-    ret->setWritePos(0);
+/**
+ * Duplicate
+ * Same as clone(), named after Java's ByteBuffer.duplicate(). Unlike Java, writes to either buffer are not visible to
+ * the other: the writer takes a private copy first
+ *
+ * @return A pointer to the new ByteBuffer
+ */
+std::unique_ptr<ByteBuffer> ByteBuffer::duplicate() const {
+    return clone();
+}
 
+/**
+ * Slice
+ * Allocate a ByteBuffer on the heap whose contents are the bytes [offset, offset+len) of this buffer, without copying
+ * them. The range is clamped to size(). The slice's positions start at 0. Writes to the slice are private to it
+ *
+ * @param offset Index of the first byte of the slice
+ * @param len Number of bytes in the slice
+ * @return A pointer to the new ByteBuffer
+ */
+std::unique_ptr<ByteBuffer> ByteBuffer::slice(bb_size_t offset, bb_size_t len) const {
+    auto ret = std::make_unique<ByteBuffer>(*this);
+    if (offset > limit)
+        offset = limit;
+    if (len > limit - offset)
+        len = limit - offset;
+
+    ret->off = off + offset;
+    ret->base = base + offset;
+    ret->limit = len;
+    ret->rpos = 0;
+    ret->wpos = 0;
     return ret;
 }
 
+/**
+ * Is Shared
+ * Whether the backing bytes are currently shared with another ByteBuffer. The next write to a shared buffer will copy
+ *
+ * @return True if another ByteBuffer references the same backing bytes
+ */
+bool ByteBuffer::isShared() const {
+    return store.use_count() > 1;
+}
+
 /**
  * Equals, test for data equivilancy
- * Compare this ByteBuffer to another by looking at each byte in the internal buffers and making sure they are the same
+ * Compare this ByteBuffer to another by looking at the bytes in the internal buffers and making sure they are the same
  *
  * @param other A pointer to a ByteBuffer to compare to this one
  * @return True if the internal buffers match. False if otherwise
@@ -110,14 +198,11 @@ bool ByteBuffer::equals(const ByteBuffer* other) const {
     if (size() != other->size())
         return false;
 
-    // Compare byte by byte
-    uint32_t len = size();
-    for (uint32_t i = 0; i < len; i++) {
-        if (get(i) != other->get(i))
-            return false;
-    }
+    // Buffers sharing the same bytes (clones that haven't been written to) are trivially equal
+    if (limit == 0 || base == other->base)
+        return true;
 
-    return true;
+    return std::memcmp(base, other->base, limit) == 0;
 }
 
 /**
@@ -126,68 +211,368 @@ bool ByteBuffer::equals(const ByteBuffer* other) const {
  *
  * @param newSize The amount of memory to allocate
  */
-void ByteBuffer::resize(uint32_t newSize) {
-    buf.resize(newSize);
+void ByteBuffer::resize(bb_size_t newSize) {
+    if (off == 0 && store.use_count() == 1) {
+        store->resize(newSize);
+        base = store->data();
+        if (newSize > limit)
+            std::memset(base + limit, 0, newSize - limit);
+        limit = newSize;
+    } else {
+        detach(newSize);
+    }
     rpos = 0;
     wpos = 0;
 }
 
+/**
+ * Compact
+ * Discard the bytes that have already been read and move the unread bytes [rpos, wpos) to the front, so a long
+ * lived connection buffer can keep appending without growing forever. Afterwards rpos is 0, wpos and size() are the
+ * number of unread bytes and the mark is cleared. The reservation is kept.
+ * If the bytes are shared, only the unread bytes are copied into new storage
+ */
+void ByteBuffer::compact() {
+    const bb_size_t endPos = wpos < limit ? wpos : limit;
+    const bb_size_t begin = rpos < endPos ? rpos : endPos;
+    const bb_size_t unread = endPos - begin;
+
+    if (off == 0 && store.use_count() == 1) {
+        if (begin > 0 && unread > 0)
+            std::memmove(base, base + begin, unread);
+        store->resize(unread);
+    } else {
+        auto fresh = newStorage();
+        fresh->reserve(unread);
+        fresh->assign(base + begin, base + endPos);
+        store = std::move(fresh);
+        off = 0;
+    }
+
+    base = store->data();
+    limit = unread;
+    rpos = 0;
+    wpos = unread;
+    markPos = 0;
+}
+
+/**
+ * Flip
+ * Switch from writing to reading: the buffer is cut off at the write position and reading starts over from 0.
+ * Nothing is copied or freed
+ */
+void ByteBuffer::flip() {
+    if (wpos < limit)
+        limit = wpos;
+    rpos = 0;
+    markPos = 0;
+}
+
 /**
  * Size
  * Returns the size of the internal buffer...not necessarily the length of bytes used as data!
  *
  * @return size of the internal buffer
  */
-uint32_t ByteBuffer::size() const {
-    return buf.size();
+bb_size_t ByteBuffer::size() const {
+    return limit;
+}
+
+/**
+ * Capacity
+ * Returns how many bytes the buffer can hold before writing past size() has to reallocate. A slice or a buffer
+ * that shares its bytes copies on its next write anyway, so its capacity is just its size
+ *
+ * @return Capacity of the internal buffer
+ */
+bb_size_t ByteBuffer::capacity() const {
+    if (off != 0 || store.use_count() != 1)
+        return limit;
+    return store->capacity();
+}
+
+/**
+ * New Storage
+ * Allocate an empty Storage (and its shared_ptr control block) from this buffer's memory resource
+ *
+ * @return Pointer to the new, empty Storage
+ */
+std::shared_ptr<ByteBuffer::Storage> ByteBuffer::newStorage() const {
+    return std::allocate_shared<Storage>(std::pmr::polymorphic_allocator<Storage>(resource));
+}
+
+/**
+ * Detach
+ * Give this buffer a private copy of its bytes, resized to newLen. Called before writing to bytes that are shared
+ * with another ByteBuffer, or when a slice needs to grow. A slice that is already the only user of its storage just
+ * moves its bytes to the front instead of copying
+ *
+ * @param newLen Size of the buffer after detaching
+ */
+void ByteBuffer::detach(size_t newLen) {
+    const size_t keep = newLen < limit ? newLen : limit;
+
+    if (store.use_count() == 1) {
+        std::memmove(store->data(), base, keep);
+        store->resize(newLen);
+    } else {
+        auto fresh = newStorage();
+        fresh->reserve(newLen);
+        fresh->assign(base, base + keep);
+        fresh->resize(newLen);
+        store = std::move(fresh);
+    }
+
+    off = 0;
+    base = store->data();
+    std::memset(base + keep, 0, newLen - keep);
+    limit = newLen;
+}
+
+/**
+ * Prepare
+ * Get n bytes of writable space starting at the write position, growing the storage if needed without touching
+ * size(). The bytes are uninitialized. The span is invalidated by any other write to the buffer.
+ * Follow with commit() once the bytes have been written
+ *
+ * @param n Number of bytes to make room for
+ * @return Writable span of n bytes at the write position. Empty, with the error state set, if the buffer would grow
+ *         past what bb_size_t can index
+ */
+std::span<uint8_t> ByteBuffer::prepare(bb_size_t n) {
+    makeWritable(0, limit);
+
+    // Trim anything left prepared by an earlier call, so commit() can't reach past this one
+    const size_t end = static_cast<size_t>(wpos) + n;
+    if constexpr (sizeof(bb_size_t) < sizeof(size_t)) {
+        if (end > std::numeric_limits<bb_size_t>::max()) {
+            failed = true;
+            return {};
+        }
+    }
+    store->resize(end > limit ? end : limit);
+    base = store->data();
+    if (wpos > limit) // Don't expose garbage between the end and a write position set past it
+        std::memset(base + limit, 0, wpos - limit);
+
+    return std::span<uint8_t>(base + wpos, n);
+}
+
+/**
+ * Commit
+ * Make n bytes written into the span returned by prepare() part of the buffer and advance the write position past
+ * them. n is clamped to the space that was prepared
+ *
+ * @param n Number of bytes written
+ */
+void ByteBuffer::commit(bb_size_t n) {
+    size_t end = static_cast<size_t>(wpos) + n;
+    const size_t avail = (off == 0 && store.use_count() == 1) ? store->size() : limit;
+    if (end > avail)
+        end = avail;
+    if (end < wpos)
+        return;
+
+    if (end > limit)
+        limit = end;
+    wpos = end;
+}
+
+#ifndef _WIN32
+/**
+ * Get Readable Iov
+ * Describe the unread bytes [rpos, size()) for writev()/sendmsg(), without copying them. The iovecs are invalidated
+ * by any write to the buffer
+ *
+ * @param out iovecs to fill
+ * @return Number of iovecs filled: 0 if there is nothing to read or out is empty, 1 otherwise
+ */
+size_t ByteBuffer::getReadableIov(std::span<iovec> out) const {
+    if (out.empty() || rpos >= limit)
+        return 0;
+
+    out[0].iov_base = base + rpos;
+    out[0].iov_len = limit - rpos;
+    return 1;
+}
+#endif
+
+// Searching
+
+/**
+ * Find Bytes
+ * Search for a byte pattern. Every byte in the buffer is considered, including zeroes
+ *
+ * @param pattern Byte pattern to search for
+ * @param len Length of the pattern
+ * @param start Index to start from. By default, start is 0
+ * @return Absolute index of the first occurrence of the pattern at or after start, -1 if not found
+ */
+int64_t ByteBuffer::findBytes(const uint8_t* const pattern, bb_size_t len, bb_size_t start) const {
+    if (start >= limit)
+        return -1;
+
+    int64_t pos = scanFindBytes(base + start, limit - start, pattern, len);
+    return pos < 0 ? -1 : pos + start;
+}
+
+/**
+ * Find End of Line
+ * Search for the first CR or LF, vectorized (see scanFindEol)
+ *
+ * @param start Index to start from. By default, start is 0
+ * @return Absolute index of the first CR or LF at or after start, -1 if not found
+ */
+int64_t ByteBuffer::findEol(bb_size_t start) const {
+    if (start >= limit)
+        return -1;
+
+    int64_t pos = scanFindEol(base + start, limit - start);
+    return pos < 0 ? -1 : pos + start;
+}
+
+// Hashing
+
+/**
+ * Hash64
+ * 64-bit non-cryptographic hash (xxHash64) of the contents of the buffer. Equal contents always hash equally,
+ * regardless of read/write positions
+ *
+ * @param seed Seed value. By default, seed is 0
+ * @return 64-bit hash of the contents
+ */
+uint64_t ByteBuffer::hash64(uint64_t seed) const {
+    return scanHash64(base, limit, seed);
+}
+
+/**
+ * Hash64
+ * 64-bit non-cryptographic hash (xxHash64) of the bytes [offset, offset+len). The range is clamped to size()
+ *
+ * @param offset Index of the first byte to hash
+ * @param len Number of bytes to hash
+ * @param seed Seed value. By default, seed is 0
+ * @return 64-bit hash of the range
+ */
+uint64_t ByteBuffer::hash64(bb_size_t offset, bb_size_t len, uint64_t seed) const {
+    if (offset > limit)
+        offset = limit;
+    if (len > limit - offset)
+        len = limit - offset;
+    return scanHash64(base + offset, len, seed);
+}
+
+/**
+ * CRC-32C
+ * Castagnoli CRC of the contents of the buffer
+ *
+ * @param crc CRC of any preceding data when continuing a running checksum. By default, crc is 0 (new checksum)
+ * @return CRC-32C
+ */
+uint32_t ByteBuffer::crc32c(uint32_t crc) const {
+    return scanCrc32c(base, limit, crc);
+}
+
+/**
+ * CRC-32C
+ * Castagnoli CRC of the bytes [offset, offset+len). The range is clamped to size(). Checksumming a buffer in pieces,
+ * passing each result into the next call, gives the same result as checksumming it in one go
+ *
+ * @param offset Index of the first byte to checksum
+ * @param len Number of bytes to checksum
+ * @param crc CRC of any preceding data when continuing a running checksum. By default, crc is 0 (new checksum)
+ * @return CRC-32C
+ */
+uint32_t ByteBuffer::crc32c(bb_size_t offset, bb_size_t len, uint32_t crc) const {
+    if (offset > limit)
+        offset = limit;
+    if (len > limit - offset)
+        len = limit - offset;
+    return scanCrc32c(base + offset, len, crc);
 }
 
 // Replacement
 
 /**
  * Replace
- * Replace occurrence of a particular byte, key, with the byte rep
+ * Replace occurrence of a particular byte, key, with the byte rep. Every byte from start to the end of the buffer is
+ * considered, including zeroes
  *
  * @param key Byte to find for replacement
  * @param rep Byte to replace the found key with
  * @param start Index to start from. By default, start is 0
  * @param firstOccurrenceOnly If true, only replace the first occurrence of the key. If false, replace all occurrences. False by default
  */
-void ByteBuffer::replace(uint8_t key, uint8_t rep, uint32_t start, bool firstOccurrenceOnly) {
-    uint32_t len = buf.size();
-    for (uint32_t i = start; i < len; i++) {
-        uint8_t data = read<uint8_t>(i);
-        // Wasn't actually found, bounds of buffer were exceeded
-        if ((key != 0) && (data == 0))
-            break;
-
-        // Key was found in array, perform replacement
-        if (data == key) {
-            buf[i] = rep;
-            if (firstOccurrenceOnly)
-                return;
+void ByteBuffer::replace(uint8_t key, uint8_t rep, bb_size_t start, bool firstOccurrenceOnly) {
+    if (start >= limit)
+        return;
+
+    if (firstOccurrenceOnly) {
+        int64_t pos = scanFindByte(base + start, limit - start, key);
+        if (pos >= 0) {
+            makeWritable(0, limit);
+            base[start + pos] = rep;
         }
+        return;
     }
+
+    makeWritable(0, limit);
+    scanReplaceByte(base + start, limit - start, key, rep);
+}
+
+/**
+ * Replace Any
+ * Replace every occurrence of any byte in a set of keys with the byte rep
+ *
+ * @param keys Set of bytes to find for replacement
+ * @param rep Byte to replace any found key with
+ * @param start Index to start from. By default, start is 0
+ */
+void ByteBuffer::replaceAny(std::span<const uint8_t> keys, uint8_t rep, bb_size_t start) {
+    if (start >= limit)
+        return;
+
+    makeWritable(0, limit);
+    scanReplaceAny(base + start, limit - start, keys.data(), keys.size(), rep);
+}
+
+/**
+ * Translate
+ * Replace every byte b from start to the end of the buffer with table[b]
+ *
+ * @param table Translation table, indexed by the original byte value
+ * @param start Index to start from. By default, start is 0
+ */
+void ByteBuffer::translate(const std::array<uint8_t, 256>& table, bb_size_t start) {
+    if (start >= limit)
+        return;
+
+    makeWritable(0, limit);
+    scanTranslate(base + start, limit - start, table);
 }
 
 // Read Functions
 
 uint8_t ByteBuffer::peek() const {
-    return read<uint8_t>(rpos);
+    // Looking at the end of the buffer isn't an error, so this doesn't set the error state
+    return rpos < limit ? base[rpos] : 0;
 }
 
 uint8_t ByteBuffer::get() {
     return read<uint8_t>();
 }
 
-uint8_t ByteBuffer::get(uint32_t index) const {
+uint8_t ByteBuffer::get(bb_size_t index) const {
     return read<uint8_t>(index);
 }
 
-void ByteBuffer::getBytes(uint8_t* const out_buf, uint32_t out_len) {
+void ByteBuffer::getBytes(uint8_t* const out_buf, bb_size_t out_len) {
     if (out_len == 0) return;
-    if (static_cast<size_t>(rpos) + out_len > buf.size()) return;
-    std::memcpy(out_buf, &buf[rpos], out_len);
+    if (static_cast<size_t>(rpos) + out_len > limit) {
+        failed = true;
+        return;
+    }
+    std::memcpy(out_buf, base + rpos, out_len);
     rpos += out_len;
 }
 
@@ -195,7 +580,7 @@ char ByteBuffer::getChar() {
     return read<char>();
 }
 
-char ByteBuffer::getChar(uint32_t index) const {
+char ByteBuffer::getChar(bb_size_t index) const {
     return read<char>(index);
 }
 
@@ -203,7 +588,7 @@ double ByteBuffer::getDouble() {
     return read<double>();
 }
 
-double ByteBuffer::getDouble(uint32_t index) const {
+double ByteBuffer::getDouble(bb_size_t index) const {
     return read<double>(index);
 }
 
@@ -211,7 +596,7 @@ float ByteBuffer::getFloat() {
     return read<float>();
 }
 
-float ByteBuffer::getFloat(uint32_t index) const {
+float ByteBuffer::getFloat(bb_size_t index) const {
     return read<float>(index);
 }
 
@@ -219,7 +604,7 @@ uint32_t ByteBuffer::getInt() {
     return read<uint32_t>();
 }
 
-uint32_t ByteBuffer::getInt(uint32_t index) const {
+uint32_t ByteBuffer::getInt(bb_size_t index) const {
     return read<uint32_t>(index);
 }
 
@@ -227,7 +612,7 @@ uint64_t ByteBuffer::getLong() {
     return read<uint64_t>();
 }
 
-uint64_t ByteBuffer::getLong(uint32_t index) const {
+uint64_t ByteBuffer::getLong(bb_size_t index) const {
     return read<uint64_t>(index);
 }
 
@@ -235,40 +620,92 @@ uint16_t ByteBuffer::getShort() {
     return read<uint16_t>();
 }
 
-uint16_t ByteBuffer::getShort(uint32_t index) const {
+uint16_t ByteBuffer::getShort(bb_size_t index) const {
     return read<uint16_t>(index);
 }
 
 
 // Write Functions
 
+/**
+ * Put (another ByteBuffer)
+ * Relative write of the readable region of src, [rpos, size()), like splice() but copying and leaving src unchanged
+ *
+ * @param src ByteBuffer to copy the unread bytes of. May be this buffer
+ */
 void ByteBuffer::put(const ByteBuffer* src) {
-    uint32_t len = src->size();
-    for (uint32_t i = 0; i < len; i++)
-        append<uint8_t>(src->get(i));
+    put(*src, src->getReadPos(), src->bytesRemaining());
+}
+
+/**
+ * Put (range of another ByteBuffer)
+ * Relative write of the bytes [offset, offset+len) of src, clamped to src's size. One resize and one memcpy
+ *
+ * @param src ByteBuffer to copy from. May be this buffer
+ * @param offset Index of the first byte in src to copy
+ * @param len Number of bytes to copy
+ */
+void ByteBuffer::put(const ByteBuffer& src, bb_size_t offset, bb_size_t len) {
+    if (offset > src.limit)
+        offset = src.limit;
+    if (len > src.limit - offset)
+        len = src.limit - offset;
+    if (len == 0)
+        return;
+
+    // Appending a buffer to itself: hold a reference to the current bytes so they survive the write
+    if (&src == this) {
+        const ByteBuffer hold(src);
+        putBytes(hold.base + offset, len);
+        return;
+    }
+
+    putBytes(src.base + offset, len);
+}
+
+/**
+ * Splice
+ * Move the readable region of src, [rpos, size()), to this buffer at the write position. src is cleared afterwards.
+ * When this buffer is empty it simply takes over src's backing bytes, so nothing is copied
+ *
+ * @param src ByteBuffer to move the readable bytes out of
+ */
+void ByteBuffer::splice(ByteBuffer& src) {
+    if (&src == this)
+        return;
+
+    const bb_size_t readable = src.bytesRemaining();
+    if (limit == 0 && wpos == 0) {
+        store = src.store;
+        off = src.off + src.rpos;
+        base = src.base + src.rpos;
+        limit = readable;
+        rpos = 0;
+        wpos = readable;
+    } else {
+        put(src, src.rpos, readable);
+    }
+
+    src.clear();
 }
 
 void ByteBuffer::put(uint8_t b) {
     append<uint8_t>(b);
 }
 
-void ByteBuffer::put(uint8_t b, uint32_t index) {
+void ByteBuffer::put(uint8_t b, bb_size_t index) {
     insert<uint8_t>(b, index);
 }
 
-void ByteBuffer::putBytes(const uint8_t* const b, uint32_t len) {
-    if (len == 0) return;
-    const size_t end = static_cast<size_t>(wpos) + len;
-    if (end > buf.size()) buf.resize(end);
-    std::memcpy(&buf[wpos], b, len);
-    wpos += len;
+void ByteBuffer::putBytes(const uint8_t* const b, bb_size_t len) {
+    putBytes(b, len, wpos);
 }
 
-void ByteBuffer::putBytes(const uint8_t* const b, uint32_t len, uint32_t index) {
+void ByteBuffer::putBytes(const uint8_t* const b, bb_size_t len, bb_size_t index) {
     if (len == 0) return;
-    const size_t end = static_cast<size_t>(index) + len;
-    if (end > buf.size()) buf.resize(end);
-    std::memcpy(&buf[index], b, len);
+    if (!makeWritable(index, len))
+        return;
+    std::memcpy(base + index, b, len);
     wpos = index + len;
 }
 
@@ -276,7 +713,7 @@ void ByteBuffer::putChar(char value) {
     append<char>(value);
 }
 
-void ByteBuffer::putChar(char value, uint32_t index) {
+void ByteBuffer::putChar(char value, bb_size_t index) {
     insert<char>(value, index);
 }
 
@@ -284,14 +721,14 @@ void ByteBuffer::putDouble(double value) {
     append<double>(value);
 }
 
-void ByteBuffer::putDouble(double value, uint32_t index) {
+void ByteBuffer::putDouble(double value, bb_size_t index) {
     insert<double>(value, index);
 }
 void ByteBuffer::putFloat(float value) {
     append<float>(value);
 }
 
-void ByteBuffer::putFloat(float value, uint32_t index) {
+void ByteBuffer::putFloat(float value, bb_size_t index) {
     insert<float>(value, index);
 }
 
@@ -299,7 +736,7 @@ void ByteBuffer::putInt(uint32_t value) {
     append<uint32_t>(value);
 }
 
-void ByteBuffer::putInt(uint32_t value, uint32_t index) {
+void ByteBuffer::putInt(uint32_t value, bb_size_t index) {
     insert<uint32_t>(value, index);
 }
 
@@ -307,7 +744,7 @@ void ByteBuffer::putLong(uint64_t value) {
     append<uint64_t>(value);
 }
 
-void ByteBuffer::putLong(uint64_t value, uint32_t index) {
+void ByteBuffer::putLong(uint64_t value, bb_size_t index) {
     insert<uint64_t>(value, index);
 }
 
@@ -315,7 +752,7 @@ void ByteBuffer::putShort(uint16_t value) {
     append<uint16_t>(value);
 }
 
-void ByteBuffer::putShort(uint16_t value, uint32_t index) {
+void ByteBuffer::putShort(uint16_t value, bb_size_t index) {
     insert<uint16_t>(value, index);
 }
 
@@ -330,43 +767,43 @@ std::string ByteBuffer::getName() const {
 }
 
 void ByteBuffer::printInfo() const {
-    uint32_t length = buf.size();
+    bb_size_t length = limit;
     std::print("ByteBuffer {} Length: {}. Info Print\n", name, length);
 }
 
 void ByteBuffer::printAH() const {
-    uint32_t length = buf.size();
+    bb_size_t length = limit;
     std::print("ByteBuffer {} Length: {}. ASCII & Hex Print\n", name, length);
-    for (uint32_t i = 0; i < length; i++) {
-        std::print("0x{:02x} ", static_cast<uint8_t>(buf[i]));
+    for (bb_size_t i = 0; i < length; i++) {
+        std::print("0x{:02x} ", base[i]);
     }
     std::print("\n");
-    for (uint32_t i = 0; i < length; i++) {
-        std::print("{} ", (char)buf[i]);
+    for (bb_size_t i = 0; i < length; i++) {
+        std::print("{} ", (char)base[i]);
     }
     std::print("\n");
 }
 
 void ByteBuffer::printAscii() const {
-    uint32_t length = buf.size();
+    bb_size_t length = limit;
     std::print("ByteBuffer {} Length: {}. ASCII Print\n", name, length);
-    for (uint32_t i = 0; i < length; i++) {
-        std::print("{} ", (char)buf[i]);
+    for (bb_size_t i = 0; i < length; i++) {
+        std::print("{} ", (char)base[i]);
     }
     std::print("\n");
 }
 
 void ByteBuffer::printHex() const {
-    uint32_t length = buf.size();
+    bb_size_t length = limit;
     std::print("ByteBuffer {} Length: {}. Hex Print\n", name, length);
-    for (uint32_t i = 0; i < length; i++) {
-        std::print("0x{:02x} ", static_cast<uint8_t>(buf[i]));
+    for (bb_size_t i = 0; i < length; i++) {
+        std::print("0x{:02x} ", base[i]);
     }
     std::print("\n");
 }
 
 void ByteBuffer::printPosition() const {
-    uint32_t length = buf.size();
+    bb_size_t length = limit;
     std::print("ByteBuffer {} Length: {} Read Pos: {}. Write Pos: {}\n", name, length, rpos, wpos);
 }
 
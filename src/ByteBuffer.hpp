@@ -19,15 +19,30 @@
 #ifndef _BYTEBUFFER_H_
 #define _BYTEBUFFER_H_
 
+#include <array>
+#include <bit>
 #include <cstdint>
 #include <cstring>
+#include <functional>
+#include <limits>
 #include <vector>
 #include <memory>
+#include <memory_resource>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "ByteScan.hpp"
 
 #ifdef BB_UTILITY
 #include <string>
 #endif
 
+#ifndef _WIN32
+#include <sys/uio.h>
+#endif
+
 // Default number of bytes to allocate in the backing buffer if no size is provided
 constexpr uint32_t BB_DEFAULT_SIZE = 4096;
 
@@ -35,98 +50,493 @@ constexpr uint32_t BB_DEFAULT_SIZE = 4096;
 namespace bb {
 #endif
 
+// Type of every size, index and position in a ByteBuffer or view. 32-bit by default, which caps a buffer at 4 GiB.
+// Define BB_64BIT_SIZES to build with 64-bit sizes for larger buffers
+#ifdef BB_64BIT_SIZES
+using bb_size_t = uint64_t;
+#else
+using bb_size_t = uint32_t;
+#endif
+
+// Byte order used on the wire by most network protocols
+constexpr std::endian BB_NETWORK_ORDER = std::endian::big;
+
+// Convert value between host byte order and byte order E. Resolved at compile time: a no-op when E is the host's
+// byte order, a single bswap otherwise
+template<std::endian E, typename T> constexpr T endianConvert(T value) {
+    static_assert(std::is_arithmetic_v<T>, "endianConvert requires an integral or floating point type");
+    if constexpr (E == std::endian::native || sizeof(T) == 1) {
+        return value;
+    } else if constexpr (std::is_integral_v<T>) {
+        return std::byteswap(value);
+    } else if constexpr (sizeof(T) == 4) {
+        return std::bit_cast<T>(std::byteswap(std::bit_cast<uint32_t>(value)));
+    } else {
+        static_assert(sizeof(T) == 8, "Unsupported floating point size");
+        return std::bit_cast<T>(std::byteswap(std::bit_cast<uint64_t>(value)));
+    }
+}
+
+// Aggregate reflection behind ByteBuffer::put(obj) / get<T>(). A plain struct is encoded field by field, in
+// declaration order and without padding. Fields may be arithmetic types, enums, std::array of those, or nested
+// structs following the same rules. The fields are discovered PFR-style, by probing how many initializers the
+// aggregate accepts and then splitting it with a structured binding, so no registration is needed.
+// Limits: at most bb_reflect::MAX_FIELDS fields, no base classes, no C array members (use std::array)
+namespace bb_reflect {
+
+constexpr size_t MAX_FIELDS = 16;
+
+// Converts to any field type. Only used in unevaluated probes
+struct AnyField {
+    template<typename U> constexpr operator U() const noexcept;
+};
+
+template<typename T> struct IsStdArray : std::false_type {};
+template<typename E, size_t N> struct IsStdArray<std::array<E, N>> : std::true_type {};
+
+template<typename T> concept Scalar = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+template<typename T> concept Aggregate = std::is_class_v<T> && std::is_aggregate_v<T> && !IsStdArray<T>::value;
+
+template<typename T, size_t... I> constexpr bool bracesWith(std::index_sequence<I...>) {
+    return requires { T{(void(I), AnyField{})...}; };
+}
+
+// Number of fields: the most initializers T{...} accepts
+template<typename T, size_t N = 0> constexpr size_t fieldCount() {
+    if constexpr (N < MAX_FIELDS && bracesWith<T>(std::make_index_sequence<N + 1>{}))
+        return fieldCount<T, N + 1>();
+    else
+        return N;
+}
+
+// Tuple of references to the fields of obj
+template<typename T> constexpr auto tieFields(T& obj) {
+    constexpr size_t n = fieldCount<std::remove_const_t<T>>();
+    static_assert(n > 0, "put/get<T> requires an aggregate with at least one field");
+    if constexpr (n == 1) {
+        auto& [f0] = obj;
+        return std::tie(f0);
+    } else if constexpr (n == 2) {
+        auto& [f0, f1] = obj;
+        return std::tie(f0, f1);
+    } else if constexpr (n == 3) {
+        auto& [f0, f1, f2] = obj;
+        return std::tie(f0, f1, f2);
+    } else if constexpr (n == 4) {
+        auto& [f0, f1, f2, f3] = obj;
+        return std::tie(f0, f1, f2, f3);
+    } else if constexpr (n == 5) {
+        auto& [f0, f1, f2, f3, f4] = obj;
+        return std::tie(f0, f1, f2, f3, f4);
+    } else if constexpr (n == 6) {
+        auto& [f0, f1, f2, f3, f4, f5] = obj;
+        return std::tie(f0, f1, f2, f3, f4, f5);
+    } else if constexpr (n == 7) {
+        auto& [f0, f1, f2, f3, f4, f5, f6] = obj;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6);
+    } else if constexpr (n == 8) {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7] = obj;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7);
+    } else if constexpr (n == 9) {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8] = obj;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8);
+    } else if constexpr (n == 10) {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9] = obj;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9);
+    } else if constexpr (n == 11) {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10] = obj;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10);
+    } else if constexpr (n == 12) {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11] = obj;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11);
+    } else if constexpr (n == 13) {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12] = obj;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12);
+    } else if constexpr (n == 14) {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13] = obj;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13);
+    } else if constexpr (n == 15) {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14] = obj;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14);
+    } else if constexpr (n == 16) {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15] = obj;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15);
+    }
+}
+
+template<typename T> constexpr size_t encodedSize();
+
+template<typename T, size_t... I> constexpr size_t fieldsSize(std::index_sequence<I...>) {
+    using Fields = decltype(tieFields(std::declval<T&>()));
+    return (encodedSize<std::remove_cvref_t<std::tuple_element_t<I, Fields>>>() + ... + 0);
+}
+
+// Exact number of bytes put(obj) writes for a T
+template<typename T> constexpr size_t encodedSize() {
+    if constexpr (Scalar<T>) {
+        return sizeof(T);
+    } else if constexpr (IsStdArray<T>::value) {
+        return std::tuple_size_v<T> * encodedSize<typename T::value_type>();
+    } else {
+        static_assert(Aggregate<T>, "put/get<T> fields must be arithmetic, enums, std::array or aggregates of those");
+        return fieldsSize<T>(std::make_index_sequence<fieldCount<T>()>{});
+    }
+}
+
+// Without padding, the in-memory layout already is the encoding, so the whole object can be copied at once
+template<typename T> constexpr bool isFlat() {
+    return std::is_trivially_copyable_v<T> && encodedSize<T>() == sizeof(T);
+}
+
+template<std::endian E, typename T> void encode(uint8_t* dst, const T& v) {
+    if constexpr (E == std::endian::native && isFlat<T>()) {
+        std::memcpy(dst, &v, sizeof(T));
+    } else if constexpr (std::is_enum_v<T>) {
+        encode<E>(dst, static_cast<std::underlying_type_t<T>>(v));
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        const T c = endianConvert<E>(v);
+        std::memcpy(dst, &c, sizeof(T));
+    } else if constexpr (IsStdArray<T>::value) {
+        constexpr size_t step = encodedSize<typename T::value_type>();
+        for (size_t i = 0; i < v.size(); i++)
+            encode<E>(dst + i * step, v[i]);
+    } else {
+        std::apply([&dst](const auto&... f) {
+            ((encode<E>(dst, f), dst += encodedSize<std::remove_cvref_t<decltype(f)>>()), ...);
+        }, tieFields(v));
+    }
+}
+
+template<std::endian E, typename T> void decode(const uint8_t* src, T& v) {
+    if constexpr (E == std::endian::native && isFlat<T>()) {
+        std::memcpy(&v, src, sizeof(T));
+    } else if constexpr (std::is_enum_v<T>) {
+        std::underlying_type_t<T> u;
+        decode<E>(src, u);
+        v = static_cast<T>(u);
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        T c;
+        std::memcpy(&c, src, sizeof(T));
+        v = endianConvert<E>(c);
+    } else if constexpr (IsStdArray<T>::value) {
+        constexpr size_t step = encodedSize<typename T::value_type>();
+        for (size_t i = 0; i < v.size(); i++)
+            decode<E>(src + i * step, v[i]);
+    } else {
+        std::apply([&src](auto&... f) {
+            ((decode<E>(src, f), src += encodedSize<std::remove_cvref_t<decltype(f)>>()), ...);
+        }, tieFields(v));
+    }
+}
+
+}
+
+// Unchecked reader over n bytes that ByteBuffer::require(n) / ByteBufferView::require(n) has already bounds checked
+// once. Reads don't check anything, so they must stay within those n bytes. The owner's read position is advanced
+// past whatever was read when the window goes out of scope. Any write to the owner invalidates the window.
+// A failed require() returns an empty window that tests false and must not be read from:
+//     if (auto w = bb.require(10)) { id = w.getInt(); len = w.getShort(); ... }
+class ReadWindow {
+public:
+    ReadWindow() = default;
+    ReadWindow(const uint8_t* first, bb_size_t len, bb_size_t& pos) : start(first), cur(first), end(first + len), rpos(&pos) {}
+    ReadWindow(const ReadWindow&) = delete;
+    ReadWindow& operator=(const ReadWindow&) = delete;
+    ~ReadWindow() {
+        if (rpos != nullptr)
+            *rpos += static_cast<bb_size_t>(cur - start);
+    }
+
+    explicit operator bool() const {
+        return rpos != nullptr;
+    }
+    bb_size_t bytesRemaining() const {
+        return static_cast<bb_size_t>(end - cur);
+    }
+
+    uint8_t get() { return take<uint8_t>(); }
+    void getBytes(uint8_t* const out_buf, bb_size_t out_len) {
+        std::memcpy(out_buf, cur, out_len);
+        cur += out_len;
+    }
+    char getChar() { return take<char>(); }
+    double getDouble() { return take<double>(); }
+    float getFloat() { return take<float>(); }
+    uint32_t getInt() { return take<uint32_t>(); }
+    uint64_t getLong() { return take<uint64_t>(); }
+    uint16_t getShort() { return take<uint16_t>(); }
+
+    template<std::endian E> double getDouble() { return endianConvert<E>(take<double>()); }
+    template<std::endian E> float getFloat() { return endianConvert<E>(take<float>()); }
+    template<std::endian E> uint32_t getInt() { return endianConvert<E>(take<uint32_t>()); }
+    template<std::endian E> uint64_t getLong() { return endianConvert<E>(take<uint64_t>()); }
+    template<std::endian E> uint16_t getShort() { return endianConvert<E>(take<uint16_t>()); }
+
+private:
+    const uint8_t* start = nullptr;
+    const uint8_t* cur = nullptr;
+    const uint8_t* end = nullptr;
+    bb_size_t* rpos = nullptr; // Owner's read position, advanced on destruction
+
+    template<typename T> T take() {
+        T val;
+        std::memcpy(&val, cur, sizeof(T));
+        cur += sizeof(T);
+        return val;
+    }
+};
+
 class ByteBuffer {
 public:
-    explicit ByteBuffer(uint32_t size = BB_DEFAULT_SIZE);
-    explicit ByteBuffer(const uint8_t* arr, uint32_t size);
+    explicit ByteBuffer(bb_size_t size = BB_DEFAULT_SIZE, std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+    explicit ByteBuffer(const uint8_t* arr, bb_size_t size, std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+    ByteBuffer(const ByteBuffer& other) = default; // O(1), shares the backing bytes until either side writes
+    ByteBuffer(ByteBuffer&& other) noexcept;
     virtual ~ByteBuffer() = default;
 
-    uint32_t bytesRemaining() const; // Number of bytes from the current read position till the end of the buffer
+    ByteBuffer& operator=(const ByteBuffer& other) = default;
+    ByteBuffer& operator=(ByteBuffer&& other) noexcept;
+
+    bb_size_t bytesRemaining() const; // Number of bytes from the current read position till the end of the buffer
     void clear(); // Clear our the vector and reset read and write positions
-    std::unique_ptr<ByteBuffer> clone(); // Return a new instance of a ByteBuffer with the exact same contents and the same state (rpos, wpos)
+    std::unique_ptr<ByteBuffer> clone() const; // Return a new instance of a ByteBuffer with the exact same contents and the same state (rpos, wpos)
+    std::unique_ptr<ByteBuffer> duplicate() const; // Java name for clone(): shared contents, independent positions
+    std::unique_ptr<ByteBuffer> slice(bb_size_t offset, bb_size_t len) const; // New buffer sharing the bytes [offset, offset+len)
     bool equals(const ByteBuffer* other) const; // Compare if the contents are equivalent
-    void resize(uint32_t newSize);
-    uint32_t size() const; // Size of internal vector
-
-    // Basic Searching (Linear)
-    template<typename T> int32_t find(T key, uint32_t start=0) {
-        int32_t ret = -1;
-        uint32_t len = buf.size();
-        for (uint32_t i = start; i < len; i++) {
-            T data = read<T>(i);
-            // Wasn't actually found, bounds of buffer were exceeded
-            if ((key != 0) && (data == 0))
-                break;
-
-            // Key was found in array
-            if (data == key) {
-                ret = i;
-                break;
-            }
+    bool operator==(const ByteBuffer& other) const {
+        return equals(&other);
+    }
+    void resize(bb_size_t newSize);
+    void compact(); // Move the unread bytes [rpos, wpos) to the front, dropping the ones already read
+    void flip(); // Truncate to the write position and rewind the read position, to read back what was written
+    bb_size_t size() const; // Size of internal vector
+    bb_size_t capacity() const; // Bytes the buffer can hold before its storage has to grow
+
+    // Direct writes, ie. recv() straight into the buffer. prepare(n) returns n writable, uninitialized bytes starting at
+    // the write position; commit(n) then makes the first n of them part of the buffer and advances the write position
+    std::span<uint8_t> prepare(bb_size_t n);
+    void commit(bb_size_t n);
+
+#ifndef _WIN32
+    // Scatter/gather. Describe the unread bytes [rpos, size()) as iovecs for writev()/sendmsg().
+    // Returns the number of entries of out that were filled. See ByteBufferChain to gather many buffers
+    size_t getReadableIov(std::span<iovec> out) const;
+#endif
+    // Sticky error state, like an iostream's failbit. Set by the first read that runs past the end (which returns 0 and
+    // reads nothing) and kept until clearError() or clear(), so a run of gets can be checked once at the end
+    bool ok() const {
+        return !failed;
+    }
+    void clearError() {
+        failed = false;
+    }
+
+    // Bounds check n bytes from the read position once and return a window for reading them without further checks.
+    // If fewer than n bytes remain, the error state is set and the returned window tests false
+    ReadWindow require(bb_size_t n) {
+        if (static_cast<size_t>(rpos) + n > limit) {
+            failed = true;
+            return {};
         }
-        return ret;
+        return ReadWindow(base + rpos, n, rpos);
+    }
+
+    bool isShared() const; // True if the backing bytes are currently shared with a clone, duplicate or slice
+
+    std::pmr::memory_resource* getMemoryResource() const { // Resource the backing bytes are allocated from
+        return resource;
+    }
+
+    const uint8_t* data() const { // Pointer to the first byte of the buffer, for read-only access (ie. ByteBufferView)
+        return base;
+    }
+
+    // Pointer for modifying the bytes [0, size()) in place, ie. decoding a message over itself. Takes a private copy
+    // first if the bytes are shared. Invalidated by anything that grows the buffer
+    uint8_t* writableData() {
+        makeWritable(0, limit);
+        return base;
+    }
+
+    // Searching. Returns the absolute index of the first match at or after start, -1 if not found
+    template<typename T> int64_t find(T key, bb_size_t start = 0) const {
+        uint8_t pattern[sizeof(T)];
+        std::memcpy(pattern, &key, sizeof(T));
+        return findBytes(pattern, sizeof(T), start);
     }
+    int64_t findBytes(const uint8_t* const pattern, bb_size_t len, bb_size_t start = 0) const;
+    int64_t findEol(bb_size_t start = 0) const; // First CR or LF, ie. the end of a text line
+
+    // Hashing. Both cover the whole buffer or [offset, offset+len), clamped to size()
+    uint64_t hash64(uint64_t seed = 0) const; // xxHash64 of the contents
+    uint64_t hash64(bb_size_t offset, bb_size_t len, uint64_t seed = 0) const;
+    uint32_t crc32c(uint32_t crc = 0) const; // CRC-32C. Pass a previous result as crc to continue a running checksum
+    uint32_t crc32c(bb_size_t offset, bb_size_t len, uint32_t crc = 0) const;
 
     // Replacement
-    void replace(uint8_t key, uint8_t rep, uint32_t start = 0, bool firstOccurrenceOnly=false);
+    void replace(uint8_t key, uint8_t rep, bb_size_t start = 0, bool firstOccurrenceOnly=false);
+    void replaceAny(std::span<const uint8_t> keys, uint8_t rep, bb_size_t start = 0); // Replace every byte in the set keys with rep
+    void translate(const std::array<uint8_t, 256>& table, bb_size_t start = 0); // Map every byte b to table[b]
 
     // Read
 
     uint8_t peek() const; // Relative peek. Reads and returns the next byte in the buffer from the current position but does not increment the read position
     uint8_t get(); // Relative get method. Reads the byte at the buffers current position then increments the position
-    uint8_t get(uint32_t index) const; // Absolute get method. Read byte at index
-    void getBytes(uint8_t* const out_buf, uint32_t out_len); // Absolute read into array buf of length len
+    uint8_t get(bb_size_t index) const; // Absolute get method. Read byte at index
+    void getBytes(uint8_t* const out_buf, bb_size_t out_len); // Absolute read into array buf of length len
     char getChar(); // Relative
-    char getChar(uint32_t index) const; // Absolute
+    char getChar(bb_size_t index) const; // Absolute
     double getDouble();
-    double getDouble(uint32_t index) const;
+    double getDouble(bb_size_t index) const;
     float getFloat();
-    float getFloat(uint32_t index) const;
+    float getFloat(bb_size_t index) const;
     uint32_t getInt();
-    uint32_t getInt(uint32_t index) const;
+    uint32_t getInt(bb_size_t index) const;
     uint64_t getLong();
-    uint64_t getLong(uint32_t index) const;
+    uint64_t getLong(bb_size_t index) const;
     uint16_t getShort();
-    uint16_t getShort(uint32_t index) const;
+    uint16_t getShort(bb_size_t index) const;
+
+    // Bulk read of an array of fundamental values with one bounds check and one copy, ie. getArray<uint32_t>(samples).
+    // Nothing is read if fewer than out.size_bytes() bytes remain. Give E to convert from that byte order
+    template<typename T, std::endian E = std::endian::native> void getArray(std::span<T> out) {
+        static_assert(std::is_arithmetic_v<T>, "getArray only supports fundamental types");
+        const size_t bytes = out.size_bytes();
+        if (bytes == 0)
+            return;
+        if (static_cast<size_t>(rpos) + bytes > limit) {
+            failed = true;
+            return;
+        }
+
+        if constexpr (E == std::endian::native || sizeof(T) == 1)
+            std::memcpy(out.data(), base + rpos, bytes);
+        else
+            scanByteSwap(reinterpret_cast<uint8_t*>(out.data()), base + rpos, sizeof(T), out.size());
+        rpos += bytes;
+    }
+
+    // Read a struct written by put(obj), ie. get<LoginMsg>(). Returns T{} without reading if too few bytes remain.
+    // Give E to convert every field from that byte order
+    template<bb_reflect::Aggregate T, std::endian E = std::endian::native> T get() {
+        constexpr size_t bytes = bb_reflect::encodedSize<T>();
+        T obj{};
+        if (static_cast<size_t>(rpos) + bytes > limit) {
+            failed = true;
+            return obj;
+        }
+
+        bb_reflect::decode<E>(base + rpos, obj);
+        rpos += bytes;
+        return obj;
+    }
+
+    // Read with an explicit byte order, ie. getInt<BB_NETWORK_ORDER>()
+
+    template<std::endian E> double getDouble() { return endianConvert<E>(read<double>()); }
+    template<std::endian E> double getDouble(bb_size_t index) const { return endianConvert<E>(read<double>(index)); }
+    template<std::endian E> float getFloat() { return endianConvert<E>(read<float>()); }
+    template<std::endian E> float getFloat(bb_size_t index) const { return endianConvert<E>(read<float>(index)); }
+    template<std::endian E> uint32_t getInt() { return endianConvert<E>(read<uint32_t>()); }
+    template<std::endian E> uint32_t getInt(bb_size_t index) const { return endianConvert<E>(read<uint32_t>(index)); }
+    template<std::endian E> uint64_t getLong() { return endianConvert<E>(read<uint64_t>()); }
+    template<std::endian E> uint64_t getLong(bb_size_t index) const { return endianConvert<E>(read<uint64_t>(index)); }
+    template<std::endian E> uint16_t getShort() { return endianConvert<E>(read<uint16_t>()); }
+    template<std::endian E> uint16_t getShort(bb_size_t index) const { return endianConvert<E>(read<uint16_t>(index)); }
 
     // Write
 
-    void put(const ByteBuffer* src); // Relative write of the entire contents of another ByteBuffer (src)
+    void put(const ByteBuffer* src); // Relative write of src's unread bytes [rpos, size())
+    void put(const ByteBuffer& src, bb_size_t offset, bb_size_t len); // Relative write of src's bytes [offset, offset+len)
+    void splice(ByteBuffer& src); // Move src's unread bytes to this buffer's write position, then clear src
     void put(uint8_t b); // Relative write
-    void put(uint8_t b, uint32_t index); // Absolute write at index
-    void putBytes(const uint8_t* const b, uint32_t len); // Relative write
-    void putBytes(const uint8_t* const b, uint32_t len, uint32_t index); // Absolute write starting at index
+    void put(uint8_t b, bb_size_t index); // Absolute write at index
+    void putBytes(const uint8_t* const b, bb_size_t len); // Relative write
+    void putBytes(const uint8_t* const b, bb_size_t len, bb_size_t index); // Absolute write starting at index
     void putChar(char value); // Relative
-    void putChar(char value, uint32_t index); // Absolute
+    void putChar(char value, bb_size_t index); // Absolute
     void putDouble(double value);
-    void putDouble(double value, uint32_t index);
+    void putDouble(double value, bb_size_t index);
     void putFloat(float value);
-    void putFloat(float value, uint32_t index);
+    void putFloat(float value, bb_size_t index);
     void putInt(uint32_t value);
-    void putInt(uint32_t value, uint32_t index);
+    void putInt(uint32_t value, bb_size_t index);
     void putLong(uint64_t value);
-    void putLong(uint64_t value, uint32_t index);
+    void putLong(uint64_t value, bb_size_t index);
     void putShort(uint16_t value);
-    void putShort(uint16_t value, uint32_t index);
+    void putShort(uint16_t value, bb_size_t index);
+
+    // Bulk write of an array of fundamental values with one bounds check and one copy, ie. putArray<uint32_t>(samples).
+    // Give E to store the values in that byte order, ie. putArray<uint32_t, BB_NETWORK_ORDER>(samples)
+    template<typename T, std::endian E = std::endian::native> void putArray(std::span<const T> values) {
+        static_assert(std::is_arithmetic_v<T>, "putArray only supports fundamental types");
+        const size_t bytes = values.size_bytes();
+        if (bytes == 0)
+            return;
+
+        if (!makeWritable(wpos, bytes))
+            return;
+        if constexpr (E == std::endian::native || sizeof(T) == 1)
+            std::memcpy(base + wpos, values.data(), bytes);
+        else
+            scanByteSwap(base + wpos, reinterpret_cast<const uint8_t*>(values.data()), sizeof(T), values.size());
+        wpos += bytes;
+    }
+
+    // Write a struct field by field, ie. put(loginMsg) (see bb_reflect above). The encoded size is known at compile
+    // time, so the space is made once; padding-free structs are written with one memcpy.
+    // Give E to store every field in that byte order, ie. put<BB_NETWORK_ORDER>(loginMsg)
+    template<std::endian E = std::endian::native, bb_reflect::Aggregate T> void put(const T& obj) {
+        constexpr size_t bytes = bb_reflect::encodedSize<T>();
+        if (!makeWritable(wpos, bytes))
+            return;
+        bb_reflect::encode<E>(base + wpos, obj);
+        wpos += bytes;
+    }
+
+    // Write with an explicit byte order, ie. putInt<BB_NETWORK_ORDER>(value)
+
+    template<std::endian E> void putDouble(double value) { append<double>(endianConvert<E>(value)); }
+    template<std::endian E> void putDouble(double value, bb_size_t index) { insert<double>(endianConvert<E>(value), index); }
+    template<std::endian E> void putFloat(float value) { append<float>(endianConvert<E>(value)); }
+    template<std::endian E> void putFloat(float value, bb_size_t index) { insert<float>(endianConvert<E>(value), index); }
+    template<std::endian E> void putInt(uint32_t value) { append<uint32_t>(endianConvert<E>(value)); }
+    template<std::endian E> void putInt(uint32_t value, bb_size_t index) { insert<uint32_t>(endianConvert<E>(value), index); }
+    template<std::endian E> void putLong(uint64_t value) { append<uint64_t>(endianConvert<E>(value)); }
+    template<std::endian E> void putLong(uint64_t value, bb_size_t index) { insert<uint64_t>(endianConvert<E>(value), index); }
+    template<std::endian E> void putShort(uint16_t value) { append<uint16_t>(endianConvert<E>(value)); }
+    template<std::endian E> void putShort(uint16_t value, bb_size_t index) { insert<uint16_t>(endianConvert<E>(value), index); }
 
     // Buffer Position Accessors & Mutators
 
-    void setReadPos(uint32_t r) {
+    void setReadPos(bb_size_t r) {
         rpos = r;
     }
 
-    uint32_t getReadPos() const {
+    bb_size_t getReadPos() const {
         return rpos;
     }
 
-    void setWritePos(uint32_t w) {
+    void setWritePos(bb_size_t w) {
         wpos = w;
     }
 
-    uint32_t getWritePos() const {
+    bb_size_t getWritePos() const {
         return wpos;
     }
 
+    void mark() { // Remember the current read position
+        markPos = rpos;
+    }
+
+    void reset() { // Return the read position to the last mark(), or 0 if there is none
+        rpos = markPos;
+    }
+
+    void rewind() { // Read again from the start
+        rpos = 0;
+    }
+
     // Utility Functions
 #ifdef BB_UTILITY
     void setName(std::string_view n);
@@ -139,9 +549,39 @@ public:
 #endif
 
 private:
-    uint32_t rpos = 0;
-    uint32_t wpos = 0;
-    std::vector<uint8_t> buf;
+    // Allocates from a memory resource like polymorphic_allocator, but default-initializes instead of
+    // value-initializing, so growing the storage doesn't zero bytes that are about to be overwritten
+    template<typename T> class UninitAllocator : public std::pmr::polymorphic_allocator<T> {
+    public:
+        using std::pmr::polymorphic_allocator<T>::polymorphic_allocator;
+
+        template<typename U> void construct(U* p) noexcept {
+            ::new (static_cast<void*>(p)) U;
+        }
+        template<typename U, typename... Args> void construct(U* p, Args&&... args) {
+            ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+        }
+
+        UninitAllocator select_on_container_copy_construction() const {
+            return UninitAllocator(this->resource());
+        }
+    };
+
+    // Backing vector. Its size can run past limit after prepare(); those extra bytes aren't part of the buffer yet
+    using Storage = std::vector<uint8_t, UninitAllocator<uint8_t>>;
+
+    std::pmr::memory_resource* resource = nullptr;
+
+    // Backing bytes. Clones, duplicates and slices share the same Storage until one of them writes, at which point
+    // the writer takes a private copy (copy-on-write)
+    std::shared_ptr<Storage> store;
+    uint8_t* base = nullptr; // Cached store->data() + off
+    bb_size_t off = 0; // Offset of this buffer's first byte within store. Only non-zero for slices
+    bb_size_t limit = 0; // Number of bytes in this buffer (size())
+    bb_size_t rpos = 0;
+    bb_size_t wpos = 0;
+    bb_size_t markPos = 0;
+    mutable bool failed = false; // See ok(). Absolute reads are const but still set it
 
 #ifdef BB_UTILITY
     std::string name = "";
@@ -153,38 +593,70 @@ private:
         return data;
     }
 
-    template<typename T> T read(uint32_t index) const {
-        if (index + sizeof(T) <= buf.size()) {
+    template<typename T> T read(bb_size_t index) const {
+        if (index + sizeof(T) <= limit) {
             T val;
-            std::memcpy(&val, &buf[index], sizeof(T));
+            std::memcpy(&val, base + index, sizeof(T));
             return val;
         }
+        failed = true;
         return T{};
     }
 
     template<typename T> void append(T data) {
-        constexpr size_t s = sizeof(T);
+        insert<T>(data, wpos);
+    }
 
-        if (size() < static_cast<size_t>(wpos) + s)
-            buf.resize(static_cast<size_t>(wpos) + s);
-        memcpy(&buf[wpos], (uint8_t*)&data, s);
+    template<typename T> void insert(T data, bb_size_t index) {
+        if (!makeWritable(index, sizeof(T)))
+            return;
 
-        wpos += s;
+        memcpy(base + index, (uint8_t*)&data, sizeof(T));
+        wpos = index + sizeof(T);
     }
 
-    template<typename T> void insert(T data, uint32_t index) {
-        const size_t end = static_cast<size_t>(index) + sizeof(T);
-        if (end > size()) {
-            buf.resize(end);
+    // Ensure this buffer exclusively owns its bytes and that size() is at least index + len. Must be called before
+    // writing len bytes at index. New bytes are left uninitialized, except for any gap between the old end and index.
+    // Returns false (and sets the error state) if index + len doesn't fit in bb_size_t: the write must be dropped
+    bool makeWritable(size_t index, size_t len) {
+        const size_t end = index + len;
+        if constexpr (sizeof(bb_size_t) < sizeof(size_t)) {
+            if (end > std::numeric_limits<bb_size_t>::max()) [[unlikely]] {
+                failed = true;
+                return false;
+            }
         }
+        if (off == 0 && store.use_count() == 1) [[likely]] {
+            if (end > limit) {
+                if (end > store->size()) // Storage may already be longer than limit after prepare()
+                    store->resize(end);
+                base = store->data();
+                if (index > limit)
+                    std::memset(base + limit, 0, index - limit);
+                limit = end;
+            }
+            return true;
+        }
+        detach(end > limit ? end : limit);
+        return true;
+    }
 
-        memcpy(&buf[index], (uint8_t*)&data, sizeof(T));
-        wpos = index + sizeof(T);
+    std::shared_ptr<Storage> newStorage() const;
+    void detach(size_t newLen);
+};
+
+// Hash functor over the contents of a ByteBuffer, so buffers can be used as unordered_map / unordered_set keys
+struct ByteBufferHash {
+    size_t operator()(const ByteBuffer& b) const noexcept {
+        return static_cast<size_t>(b.hash64());
     }
 };
 
 #ifdef BB_USE_NS
 }
+template<> struct std::hash<bb::ByteBuffer> : bb::ByteBufferHash {};
+#else
+template<> struct std::hash<ByteBuffer> : ByteBufferHash {};
 #endif
 
 #endif
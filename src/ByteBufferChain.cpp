@@ -0,0 +1,207 @@
+/**
+ ByteBuffer
+ ByteBufferChain.cpp
+ Copyright 2011-2025 Ramsey Kant
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "ByteBufferChain.hpp"
+
+#ifndef _WIN32
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+#include <unistd.h>
+
+// Most iovecs a single readv()/writev() accepts
+#ifdef IOV_MAX
+#define BB_IOV_MAX IOV_MAX
+#else
+#define BB_IOV_MAX 1024
+#endif
+
+#ifdef BB_USE_NS
+namespace bb {
+#endif
+
+/**
+ * Append
+ * Add the unread bytes of buf to the end of the chain. Nothing is copied: the chain keeps a copy of buf that shares
+ * its backing bytes
+ *
+ * @param buf ByteBuffer whose bytes [rpos, size()) are added
+ */
+void ByteBufferChain::append(const ByteBuffer& buf) {
+    if (buf.bytesRemaining() == 0)
+        return;
+
+    const ByteBuffer& held = owned.emplace_back(buf);
+    iov.push_back({const_cast<uint8_t*>(held.data() + held.getReadPos()), held.bytesRemaining()});
+    total += held.bytesRemaining();
+}
+
+/**
+ * Append
+ * Add borrowed bytes to the end of the chain
+ *
+ * @param bytes Memory to add. Must stay valid until it has been consumed or the chain is cleared
+ */
+void ByteBufferChain::append(std::span<const uint8_t> bytes) {
+    if (bytes.empty())
+        return;
+
+    iov.push_back({const_cast<uint8_t*>(bytes.data()), bytes.size()});
+    total += bytes.size();
+}
+
+/**
+ * Append Copy
+ * Add a copy of bytes to the end of the chain. Small copies share blocks owned by the chain, so this is meant for the
+ * few bytes of framing between borrowed pieces (ie. a chunk-size line). Larger ones are held in a ByteBuffer
+ *
+ * @param bytes Bytes to copy. Need not stay valid after the call
+ */
+void ByteBufferChain::appendCopy(std::span<const uint8_t> bytes) {
+    if (bytes.empty())
+        return;
+    if (bytes.size() > COPY_BLOCK_SIZE) {
+        append(ByteBuffer(bytes.data(), static_cast<bb_size_t>(bytes.size())));
+        return;
+    }
+
+    if (COPY_BLOCK_SIZE - copyUsed < bytes.size()) {
+        copies.emplace_back();
+        copyUsed = 0;
+    }
+    uint8_t* dst = copies.back().data() + copyUsed;
+    std::memcpy(dst, bytes.data(), bytes.size());
+    copyUsed += bytes.size();
+
+    iov.push_back({dst, bytes.size()});
+    total += bytes.size();
+}
+
+/**
+ * Clear
+ * Remove everything from the chain and release the held ByteBuffers
+ */
+void ByteBufferChain::clear() {
+    owned.clear();
+    copies.clear();
+    copyUsed = COPY_BLOCK_SIZE;
+    iov.clear();
+    head = 0;
+    total = 0;
+}
+
+/**
+ * iovecs
+ * The unsent bytes as an iovec array, ready for writev()/sendmsg(). Invalidated by append(), consume() and clear()
+ *
+ * @return Span over the iovecs for the unsent bytes
+ */
+std::span<const iovec> ByteBufferChain::iovecs() const {
+    return std::span<const iovec>(iov).subspan(head);
+}
+
+/**
+ * Consume
+ * Drop bytes from the front of the chain, usually the number just written by writev()/sendmsg(). Once everything has
+ * been consumed the chain is cleared
+ *
+ * @param n Number of bytes to drop
+ */
+void ByteBufferChain::consume(size_t n) {
+    while (n > 0 && head < iov.size()) {
+        iovec& v = iov[head];
+        if (n < v.iov_len) {
+            v.iov_base = static_cast<uint8_t*>(v.iov_base) + n;
+            v.iov_len -= n;
+            total -= n;
+            return;
+        }
+        n -= v.iov_len;
+        total -= v.iov_len;
+        head++;
+    }
+
+    if (head == iov.size())
+        clear();
+}
+
+/**
+ * writev
+ * Write the unsent bytes to fd with one writev() call and consume however many were written. Interrupted calls are
+ * retried
+ *
+ * @param fd File descriptor or socket to write to
+ * @return Result of writev(): bytes written, or -1 with errno set
+ */
+ssize_t ByteBufferChain::writev(int fd) {
+    if (empty())
+        return 0;
+
+    const int count = iov.size() - head < BB_IOV_MAX ? iov.size() - head : BB_IOV_MAX;
+    ssize_t written;
+    do {
+        written = ::writev(fd, iov.data() + head, count);
+    } while (written < 0 && errno == EINTR);
+
+    if (written > 0)
+        consume(written);
+    return written;
+}
+
+/**
+ * readv
+ * Fill several buffers from fd with a single readv(). Each buffer gets up to n bytes appended at its write position
+ * (see ByteBuffer::prepare()); a buffer is only filled once the ones before it are full
+ *
+ * @param fd File descriptor or socket to read from
+ * @param bufs Buffers to fill, in order
+ * @param n Maximum bytes to read into each buffer
+ * @return Result of readv(): bytes read, 0 at end of file, or -1 with errno set
+ */
+ssize_t ByteBufferChain::readv(int fd, std::span<ByteBuffer* const> bufs, bb_size_t n) {
+    if (bufs.size() > BB_IOV_MAX)
+        bufs = bufs.first(BB_IOV_MAX);
+
+    std::vector<iovec> vecs;
+    vecs.reserve(bufs.size());
+    for (ByteBuffer* buf : bufs) {
+        auto space = buf->prepare(n);
+        vecs.push_back({space.data(), space.size()});
+    }
+
+    ssize_t got;
+    do {
+        got = ::readv(fd, vecs.data(), vecs.size());
+    } while (got < 0 && errno == EINTR);
+
+    size_t left = got > 0 ? static_cast<size_t>(got) : 0;
+    for (ByteBuffer* buf : bufs) {
+        const bb_size_t part = left < n ? left : n;
+        buf->commit(part);
+        left -= part;
+    }
+    return got;
+}
+
+#ifdef BB_USE_NS
+}
+#endif
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ ByteBuffer
+ ByteBufferChain.hpp
+ Copyright 2011-2025 Ramsey Kant
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef _BYTEBUFFERCHAIN_H_
+#define _BYTEBUFFERCHAIN_H_
+
+// Built on struct iovec / readv / writev, so only available on POSIX systems
+#ifndef _WIN32
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include "ByteBuffer.hpp"
+
+#ifdef BB_USE_NS
+namespace bb {
+#endif
+
+// Gathers the readable bytes of many buffers into one iovec array, so they can be handed to writev()/sendmsg()
+// in a single call without first copying them together.
+// Appended ByteBuffers are held by O(1) shared copies: later writes to the originals don't change what the chain
+// sends. Appended spans are borrowed and must stay valid until they have been sent, unless added with appendCopy()
+class ByteBufferChain {
+public:
+    void append(const ByteBuffer& buf); // The bytes [rpos, size()) of buf
+    void append(std::span<const uint8_t> bytes);
+    void appendCopy(std::span<const uint8_t> bytes); // Copies bytes into the chain, for small pieces like framing
+    void clear();
+
+    bool empty() const {
+        return head == iov.size();
+    }
+    size_t totalBytes() const { // Bytes not yet consumed
+        return total;
+    }
+
+    std::span<const iovec> iovecs() const; // The unsent bytes, in order
+    void consume(size_t n); // Drop n bytes from the front, ie. after a partial writev()
+
+    ssize_t writev(int fd); // writev() as much as possible in one call and consume what was written
+
+    // Read from fd into up to n bytes at the write position of each buffer in turn, with a single readv()
+    static ssize_t readv(int fd, std::span<ByteBuffer* const> bufs, bb_size_t n);
+
+private:
+    // appendCopy() packs small copies into blocks of this size, so they don't cost an allocation each
+    static constexpr size_t COPY_BLOCK_SIZE = 256;
+
+    std::deque<ByteBuffer> owned; // Keeps appended ByteBuffers' bytes alive
+    std::deque<std::array<uint8_t, COPY_BLOCK_SIZE>> copies; // appendCopy() bytes. A deque, so blocks never move
+    size_t copyUsed = COPY_BLOCK_SIZE; // Bytes used in copies.back()
+    std::vector<iovec> iov;
+    size_t head = 0; // First iovec with unsent bytes
+    size_t total = 0;
+};
+
+#ifdef BB_USE_NS
+}
+#endif
+
+#endif
+
+#endif
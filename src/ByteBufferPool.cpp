@@ -0,0 +1,153 @@
+/**
+ ByteBuffer
+ ByteBufferPool.cpp
+ Copyright 2011-2025 Ramsey Kant
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "ByteBufferPool.hpp"
+
+#include <bit>
+
+#ifdef BB_USE_NS
+namespace bb {
+#endif
+
+void ByteBufferPool::Releaser::operator()(ByteBuffer* buf) const {
+    if (pool != nullptr)
+        pool->release(buf);
+    else
+        delete buf;
+}
+
+/**
+ * ByteBufferPool constructor
+ *
+ * @param maxRetained High-water mark for the capacity held by idle buffers. Returning a buffer that takes the pool
+ *                    over it trims the pool back down to half of it
+ */
+ByteBufferPool::ByteBufferPool(size_t maxRetained) : maxRetained(maxRetained) {
+}
+
+/**
+ * Local
+ * The calling thread's pool. It is destroyed, along with its idle buffers, when the thread exits
+ *
+ * @return Reference to this thread's pool
+ */
+ByteBufferPool& ByteBufferPool::local() {
+    thread_local ByteBufferPool pool;
+    return pool;
+}
+
+/**
+ * Acquire
+ * Lease an empty buffer that can hold at least size bytes without growing. An idle buffer of the matching capacity
+ * class is reused if there is one, otherwise a new buffer with the class' capacity is allocated.
+ * Requests larger than the biggest class get an exact-size buffer that is freed instead of pooled when returned
+ *
+ * @param size Number of bytes the caller expects to write
+ * @return Lease on the buffer. Destroying or resetting the lease returns the buffer to this pool
+ */
+ByteBufferPool::Lease ByteBufferPool::acquire(bb_size_t size) {
+    if (size > (1u << BB_POOL_MAX_CLASS_SHIFT))
+        return Lease(new ByteBuffer(size), Releaser(this));
+
+    // Round up to the next capacity class
+    int shift = size <= 1 ? 0 : std::bit_width(size - 1);
+    if (shift < BB_POOL_MIN_CLASS_SHIFT)
+        shift = BB_POOL_MIN_CLASS_SHIFT;
+
+    auto& bucket = idle[shift - BB_POOL_MIN_CLASS_SHIFT];
+    if (!bucket.empty()) {
+        std::unique_ptr<ByteBuffer> buf = std::move(bucket.back());
+        bucket.pop_back();
+        retained -= buf->capacity();
+        return Lease(buf.release(), Releaser(this));
+    }
+
+    return Lease(new ByteBuffer(1u << shift), Releaser(this));
+}
+
+/**
+ * Trim
+ * Free idle buffers, starting with the largest capacity class, until the pool retains no more than target bytes
+ *
+ * @param target Number of retained bytes to trim down to. By default, all idle buffers are freed
+ */
+void ByteBufferPool::trim(size_t target) {
+    for (size_t i = NUM_CLASSES; i-- > 0 && retained > target;) {
+        auto& bucket = idle[i];
+        while (!bucket.empty() && retained > target) {
+            retained -= bucket.back()->capacity();
+            bucket.pop_back();
+        }
+    }
+}
+
+/**
+ * Idle Count
+ * Returns the number of buffers waiting in the pool to be acquired
+ *
+ * @return Number of idle buffers
+ */
+size_t ByteBufferPool::idleCount() const {
+    size_t count = 0;
+    for (const auto& bucket : idle)
+        count += bucket.size();
+    return count;
+}
+
+/**
+ * Set Max Retained
+ * Change the high-water mark for retained bytes, trimming right away if the pool is already over it
+ *
+ * @param bytes New high-water mark
+ */
+void ByteBufferPool::setMaxRetained(size_t bytes) {
+    maxRetained = bytes;
+    if (retained > maxRetained)
+        trim(maxRetained);
+}
+
+/**
+ * Release
+ * Take back a leased buffer. It's cleared (keeping its reservation) and filed under the largest capacity class it
+ * can fully serve. Buffers that are too small, too large or that would put the pool past its high-water mark
+ * on their own are freed instead
+ *
+ * @param buf Buffer that was handed out by acquire()
+ */
+void ByteBufferPool::release(ByteBuffer* buf) {
+    std::unique_ptr<ByteBuffer> owned(buf);
+    owned->clear();
+
+    bb_size_t cap = owned->capacity();
+    if (cap < (1u << BB_POOL_MIN_CLASS_SHIFT) || cap > maxRetained)
+        return;
+
+    int shift = std::bit_width(cap) - 1; // Round down to the class this buffer can serve
+    if (shift > BB_POOL_MAX_CLASS_SHIFT)
+        return;
+
+    idle[shift - BB_POOL_MIN_CLASS_SHIFT].push_back(std::move(owned));
+    retained += cap;
+
+    if (retained > maxRetained)
+        trim(maxRetained / 2);
+}
+
+#ifdef BB_USE_NS
+}
+#endif
@@ -0,0 +1,93 @@
+/**
+ ByteBuffer
+ ByteBufferPool.hpp
+ Copyright 2011-2025 Ramsey Kant
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef _BYTEBUFFERPOOL_H_
+#define _BYTEBUFFERPOOL_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "ByteBuffer.hpp"
+
+// Smallest and largest capacity class kept by the pool, as powers of two (64 B .. 1 MiB)
+constexpr int BB_POOL_MIN_CLASS_SHIFT = 6;
+constexpr int BB_POOL_MAX_CLASS_SHIFT = 20;
+
+// Default high-water mark for the bytes a pool keeps reserved in idle buffers
+constexpr size_t BB_POOL_DEFAULT_RETAINED = 4 * 1024 * 1024;
+
+#ifdef BB_USE_NS
+namespace bb {
+#endif
+
+// Recycles ByteBuffers so that building and freeing a packet doesn't go through malloc/free each time.
+// Idle buffers are bucketed by power-of-two capacity class; acquire() hands one out as a Lease that returns it to
+// the pool (cleared, reservation kept) when the Lease goes away.
+// A pool isn't synchronized: use local() for a per-thread pool, and release leases on the thread that acquired them
+class ByteBufferPool {
+public:
+    // Returns a leased buffer to its pool
+    class Releaser {
+    public:
+        Releaser() = default;
+        explicit Releaser(ByteBufferPool* p) : pool(p) {}
+
+        void operator()(ByteBuffer* buf) const;
+
+    private:
+        ByteBufferPool* pool = nullptr;
+    };
+
+    using Lease = std::unique_ptr<ByteBuffer, Releaser>;
+
+    explicit ByteBufferPool(size_t maxRetained = BB_POOL_DEFAULT_RETAINED);
+    ByteBufferPool(const ByteBufferPool&) = delete;
+    ByteBufferPool& operator=(const ByteBufferPool&) = delete;
+
+    static ByteBufferPool& local(); // This thread's pool. Outstanding leases must be released before the thread exits
+
+    Lease acquire(bb_size_t size = BB_DEFAULT_SIZE); // Empty buffer with room for at least size bytes
+    void trim(size_t target = 0); // Free idle buffers, largest first, until at most target bytes are retained
+
+    size_t idleCount() const; // Number of idle buffers held
+    size_t retainedBytes() const { // Capacity held by idle buffers
+        return retained;
+    }
+    size_t getMaxRetained() const {
+        return maxRetained;
+    }
+    void setMaxRetained(size_t bytes);
+
+private:
+    static constexpr size_t NUM_CLASSES = BB_POOL_MAX_CLASS_SHIFT - BB_POOL_MIN_CLASS_SHIFT + 1;
+
+    std::array<std::vector<std::unique_ptr<ByteBuffer>>, NUM_CLASSES> idle;
+    size_t retained = 0;
+    size_t maxRetained;
+
+    void release(ByteBuffer* buf);
+};
+
+#ifdef BB_USE_NS
+}
+#endif
+
+#endif
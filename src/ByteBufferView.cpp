@@ -0,0 +1,278 @@
+/**
+ ByteBuffer
+ ByteBufferView.cpp
+ Copyright 2011-2025 Ramsey Kant
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "ByteBufferView.hpp"
+
+#ifdef BB_USE_NS
+namespace bb {
+#endif
+
+/**
+ * ByteBufferView constructor
+ * Borrow the memory described by data. No copy is made
+ *
+ * @param data Memory to view. Must outlive the view
+ */
+ByteBufferView::ByteBufferView(std::span<const uint8_t> data) : rbuf(data) {
+}
+
+/**
+ * ByteBufferView constructor
+ * Borrow a byte array of length size. No copy is made
+ *
+ * @param arr byte array of data (should be of length size). If NULL, the view is empty
+ * @param size Length of arr
+ */
+ByteBufferView::ByteBufferView(const uint8_t* arr, bb_size_t size) {
+    if (arr != nullptr)
+        rbuf = std::span<const uint8_t>(arr, size);
+}
+
+/**
+ * ByteBufferView constructor
+ * View the contents of a ByteBuffer. The view's read position starts at the ByteBuffer's read position.
+ * The view is invalidated by any write to src that grows or copies (copy-on-write) its backing bytes
+ *
+ * @param src ByteBuffer to view
+ */
+ByteBufferView::ByteBufferView(const ByteBuffer& src) : rbuf(src.data(), src.size()), rpos(src.getReadPos()) {
+}
+
+/**
+ * Bytes Remaining
+ * Returns the number of bytes from the current read position till the end of the view
+ *
+ * @return Number of bytes from rpos to the end (size())
+ */
+bb_size_t ByteBufferView::bytesRemaining() const {
+    return rpos >= size() ? 0 : size() - rpos;
+}
+
+/**
+ * Size
+ * Returns the length of the viewed memory
+ *
+ * @return size of the view
+ */
+bb_size_t ByteBufferView::size() const {
+    return rbuf.size();
+}
+
+// Searching
+
+/**
+ * Find Bytes
+ * Search for a byte pattern. Every byte in the view is considered, including zeroes
+ *
+ * @param pattern Byte pattern to search for
+ * @param len Length of the pattern
+ * @param start Index to start from. By default, start is 0
+ * @return Absolute index of the first occurrence of the pattern at or after start, -1 if not found
+ */
+int64_t ByteBufferView::findBytes(const uint8_t* const pattern, bb_size_t len, bb_size_t start) const {
+    if (start >= rbuf.size())
+        return -1;
+
+    int64_t pos = scanFindBytes(&rbuf[start], rbuf.size() - start, pattern, len);
+    return pos < 0 ? -1 : pos + start;
+}
+
+/**
+ * Find End of Line
+ * Search for the first CR or LF, vectorized (see scanFindEol)
+ *
+ * @param start Index to start from. By default, start is 0
+ * @return Absolute index of the first CR or LF at or after start, -1 if not found
+ */
+int64_t ByteBufferView::findEol(bb_size_t start) const {
+    if (start >= rbuf.size())
+        return -1;
+
+    int64_t pos = scanFindEol(&rbuf[start], rbuf.size() - start);
+    return pos < 0 ? -1 : pos + start;
+}
+
+// Read Functions
+
+uint8_t ByteBufferView::peek() const {
+    // Looking at the end of the view isn't an error, so this doesn't set the error state
+    return rpos < rbuf.size() ? rbuf[rpos] : 0;
+}
+
+uint8_t ByteBufferView::get() {
+    return read<uint8_t>();
+}
+
+uint8_t ByteBufferView::get(bb_size_t index) const {
+    return read<uint8_t>(index);
+}
+
+void ByteBufferView::getBytes(uint8_t* const out_buf, bb_size_t out_len) {
+    if (out_len == 0) return;
+    if (static_cast<size_t>(rpos) + out_len > rbuf.size()) {
+        failed = true;
+        return;
+    }
+    std::memcpy(out_buf, &rbuf[rpos], out_len);
+    rpos += out_len;
+}
+
+char ByteBufferView::getChar() {
+    return read<char>();
+}
+
+char ByteBufferView::getChar(bb_size_t index) const {
+    return read<char>(index);
+}
+
+double ByteBufferView::getDouble() {
+    return read<double>();
+}
+
+double ByteBufferView::getDouble(bb_size_t index) const {
+    return read<double>(index);
+}
+
+float ByteBufferView::getFloat() {
+    return read<float>();
+}
+
+float ByteBufferView::getFloat(bb_size_t index) const {
+    return read<float>(index);
+}
+
+uint32_t ByteBufferView::getInt() {
+    return read<uint32_t>();
+}
+
+uint32_t ByteBufferView::getInt(bb_size_t index) const {
+    return read<uint32_t>(index);
+}
+
+uint64_t ByteBufferView::getLong() {
+    return read<uint64_t>();
+}
+
+uint64_t ByteBufferView::getLong(bb_size_t index) const {
+    return read<uint64_t>(index);
+}
+
+uint16_t ByteBufferView::getShort() {
+    return read<uint16_t>();
+}
+
+uint16_t ByteBufferView::getShort(bb_size_t index) const {
+    return read<uint16_t>(index);
+}
+
+/**
+ * MutableByteBufferView constructor
+ * Borrow the memory described by data for reading and writing. No copy is made
+ *
+ * @param data Memory to view. Must outlive the view
+ */
+MutableByteBufferView::MutableByteBufferView(std::span<uint8_t> data) : ByteBufferView(data), wbuf(data) {
+}
+
+/**
+ * MutableByteBufferView constructor
+ * Borrow a byte array of length size for reading and writing. No copy is made
+ *
+ * @param arr byte array of data (should be of length size). If NULL, the view is empty
+ * @param size Length of arr
+ */
+MutableByteBufferView::MutableByteBufferView(uint8_t* arr, bb_size_t size) : ByteBufferView(arr, size) {
+    if (arr != nullptr)
+        wbuf = std::span<uint8_t>(arr, size);
+}
+
+// Write Functions
+
+void MutableByteBufferView::put(uint8_t b) {
+    append<uint8_t>(b);
+}
+
+void MutableByteBufferView::put(uint8_t b, bb_size_t index) {
+    insert<uint8_t>(b, index);
+}
+
+void MutableByteBufferView::putBytes(const uint8_t* const b, bb_size_t len) {
+    putBytes(b, len, wpos);
+}
+
+void MutableByteBufferView::putBytes(const uint8_t* const b, bb_size_t len, bb_size_t index) {
+    if (len == 0) return;
+    if (static_cast<size_t>(index) + len > wbuf.size()) {
+        failed = true;
+        return;
+    }
+    std::memcpy(&wbuf[index], b, len);
+    wpos = index + len;
+}
+
+void MutableByteBufferView::putChar(char value) {
+    append<char>(value);
+}
+
+void MutableByteBufferView::putChar(char value, bb_size_t index) {
+    insert<char>(value, index);
+}
+
+void MutableByteBufferView::putDouble(double value) {
+    append<double>(value);
+}
+
+void MutableByteBufferView::putDouble(double value, bb_size_t index) {
+    insert<double>(value, index);
+}
+
+void MutableByteBufferView::putFloat(float value) {
+    append<float>(value);
+}
+
+void MutableByteBufferView::putFloat(float value, bb_size_t index) {
+    insert<float>(value, index);
+}
+
+void MutableByteBufferView::putInt(uint32_t value) {
+    append<uint32_t>(value);
+}
+
+void MutableByteBufferView::putInt(uint32_t value, bb_size_t index) {
+    insert<uint32_t>(value, index);
+}
+
+void MutableByteBufferView::putLong(uint64_t value) {
+    append<uint64_t>(value);
+}
+
+void MutableByteBufferView::putLong(uint64_t value, bb_size_t index) {
+    insert<uint64_t>(value, index);
+}
+
+void MutableByteBufferView::putShort(uint16_t value) {
+    append<uint16_t>(value);
+}
+
+void MutableByteBufferView::putShort(uint16_t value, bb_size_t index) {
+    insert<uint16_t>(value, index);
+}
+
+#ifdef BB_USE_NS
+}
+#endif
@@ -0,0 +1,284 @@
+/**
+ ByteBuffer
+ ByteBufferView.hpp
+ Copyright 2011-2025 Ramsey Kant
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef _BYTEBUFFERVIEW_H_
+#define _BYTEBUFFERVIEW_H_
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+#include "ByteBuffer.hpp"
+
+#ifdef BB_USE_NS
+namespace bb {
+#endif
+
+// Read-only ByteBuffer API over memory owned by someone else (ie. a socket receive buffer). Nothing is copied,
+// so the viewed memory must outlive the view
+class ByteBufferView {
+public:
+    ByteBufferView() = default;
+    explicit ByteBufferView(std::span<const uint8_t> data);
+    explicit ByteBufferView(const uint8_t* arr, bb_size_t size);
+    explicit ByteBufferView(const ByteBuffer& src); // View the current contents of a ByteBuffer, starting at its read position
+
+    bb_size_t bytesRemaining() const; // Number of bytes from the current read position till the end of the view
+    bb_size_t size() const; // Size of the viewed memory
+
+    const uint8_t* data() const {
+        return rbuf.data();
+    }
+
+    // Sticky error state, see ByteBuffer::ok(). Also set by writes a MutableByteBufferView drops
+    bool ok() const {
+        return !failed;
+    }
+    void clearError() {
+        failed = false;
+    }
+
+    // Bounds check n bytes once and read them through the returned window without further checks. See ByteBuffer::require()
+    ReadWindow require(bb_size_t n) {
+        if (static_cast<size_t>(rpos) + n > rbuf.size()) {
+            failed = true;
+            return {};
+        }
+        return ReadWindow(rbuf.data() + rpos, n, rpos);
+    }
+
+    // Searching. Returns the absolute index of the first match at or after start, -1 if not found
+    template<typename T> int64_t find(T key, bb_size_t start = 0) const {
+        uint8_t pattern[sizeof(T)];
+        std::memcpy(pattern, &key, sizeof(T));
+        return findBytes(pattern, sizeof(T), start);
+    }
+    int64_t findBytes(const uint8_t* const pattern, bb_size_t len, bb_size_t start = 0) const;
+    int64_t findEol(bb_size_t start = 0) const; // First CR or LF, ie. the end of a text line
+
+    // Read
+
+    uint8_t peek() const; // Relative peek. Reads and returns the next byte in the view from the current position but does not increment the read position
+    uint8_t get(); // Relative get method. Reads the byte at the views current position then increments the position
+    uint8_t get(bb_size_t index) const; // Absolute get method. Read byte at index
+    void getBytes(uint8_t* const out_buf, bb_size_t out_len); // Relative read into array buf of length len
+    char getChar(); // Relative
+    char getChar(bb_size_t index) const; // Absolute
+    double getDouble();
+    double getDouble(bb_size_t index) const;
+    float getFloat();
+    float getFloat(bb_size_t index) const;
+    uint32_t getInt();
+    uint32_t getInt(bb_size_t index) const;
+    uint64_t getLong();
+    uint64_t getLong(bb_size_t index) const;
+    uint16_t getShort();
+    uint16_t getShort(bb_size_t index) const;
+
+    // Bulk read of an array of fundamental values, ie. getArray<uint32_t>(samples). Nothing is read if fewer than
+    // out.size_bytes() bytes remain. Give E to convert from that byte order
+    template<typename T, std::endian E = std::endian::native> void getArray(std::span<T> out) {
+        static_assert(std::is_arithmetic_v<T>, "getArray only supports fundamental types");
+        const size_t bytes = out.size_bytes();
+        if (bytes == 0)
+            return;
+        if (static_cast<size_t>(rpos) + bytes > rbuf.size()) {
+            failed = true;
+            return;
+        }
+
+        if constexpr (E == std::endian::native || sizeof(T) == 1)
+            std::memcpy(out.data(), &rbuf[rpos], bytes);
+        else
+            scanByteSwap(reinterpret_cast<uint8_t*>(out.data()), &rbuf[rpos], sizeof(T), out.size());
+        rpos += bytes;
+    }
+
+    // Read a struct written by ByteBuffer::put(obj), ie. get<LoginMsg>(). Returns T{} without reading if too few
+    // bytes remain. Give E to convert every field from that byte order
+    template<bb_reflect::Aggregate T, std::endian E = std::endian::native> T get() {
+        constexpr size_t bytes = bb_reflect::encodedSize<T>();
+        T obj{};
+        if (static_cast<size_t>(rpos) + bytes > rbuf.size()) {
+            failed = true;
+            return obj;
+        }
+
+        bb_reflect::decode<E>(&rbuf[rpos], obj);
+        rpos += bytes;
+        return obj;
+    }
+
+    // Read with an explicit byte order, ie. getInt<BB_NETWORK_ORDER>()
+
+    template<std::endian E> double getDouble() { return endianConvert<E>(read<double>()); }
+    template<std::endian E> double getDouble(bb_size_t index) const { return endianConvert<E>(read<double>(index)); }
+    template<std::endian E> float getFloat() { return endianConvert<E>(read<float>()); }
+    template<std::endian E> float getFloat(bb_size_t index) const { return endianConvert<E>(read<float>(index)); }
+    template<std::endian E> uint32_t getInt() { return endianConvert<E>(read<uint32_t>()); }
+    template<std::endian E> uint32_t getInt(bb_size_t index) const { return endianConvert<E>(read<uint32_t>(index)); }
+    template<std::endian E> uint64_t getLong() { return endianConvert<E>(read<uint64_t>()); }
+    template<std::endian E> uint64_t getLong(bb_size_t index) const { return endianConvert<E>(read<uint64_t>(index)); }
+    template<std::endian E> uint16_t getShort() { return endianConvert<E>(read<uint16_t>()); }
+    template<std::endian E> uint16_t getShort(bb_size_t index) const { return endianConvert<E>(read<uint16_t>(index)); }
+
+    // Read Position Accessors & Mutators
+
+    void setReadPos(bb_size_t r) {
+        rpos = r;
+    }
+
+    bb_size_t getReadPos() const {
+        return rpos;
+    }
+
+protected:
+    std::span<const uint8_t> rbuf;
+    bb_size_t rpos = 0;
+    mutable bool failed = false;
+
+    template<typename T> T read() {
+        T data = read<T>(rpos);
+        rpos += sizeof(T);
+        return data;
+    }
+
+    template<typename T> T read(bb_size_t index) const {
+        if (static_cast<size_t>(index) + sizeof(T) <= rbuf.size()) {
+            T val;
+            std::memcpy(&val, &rbuf[index], sizeof(T));
+            return val;
+        }
+        failed = true;
+        return T{};
+    }
+};
+
+// Read-write view. The viewed memory is fixed in size, so writes that would run past the end of it are dropped and
+// set the error state (see ok())
+class MutableByteBufferView : public ByteBufferView {
+public:
+    MutableByteBufferView() = default;
+    explicit MutableByteBufferView(std::span<uint8_t> data);
+    explicit MutableByteBufferView(uint8_t* arr, bb_size_t size);
+
+    using ByteBufferView::data;
+
+    uint8_t* data() {
+        return wbuf.data();
+    }
+
+    // Write
+
+    void put(uint8_t b); // Relative write
+    void put(uint8_t b, bb_size_t index); // Absolute write at index
+    void putBytes(const uint8_t* const b, bb_size_t len); // Relative write
+    void putBytes(const uint8_t* const b, bb_size_t len, bb_size_t index); // Absolute write starting at index
+    void putChar(char value); // Relative
+    void putChar(char value, bb_size_t index); // Absolute
+    void putDouble(double value);
+    void putDouble(double value, bb_size_t index);
+    void putFloat(float value);
+    void putFloat(float value, bb_size_t index);
+    void putInt(uint32_t value);
+    void putInt(uint32_t value, bb_size_t index);
+    void putLong(uint64_t value);
+    void putLong(uint64_t value, bb_size_t index);
+    void putShort(uint16_t value);
+    void putShort(uint16_t value, bb_size_t index);
+
+    // Bulk write of an array of fundamental values, ie. putArray<uint32_t>(samples). Dropped if it doesn't fit.
+    // Give E to store the values in that byte order
+    template<typename T, std::endian E = std::endian::native> void putArray(std::span<const T> values) {
+        static_assert(std::is_arithmetic_v<T>, "putArray only supports fundamental types");
+        const size_t bytes = values.size_bytes();
+        if (bytes == 0)
+            return;
+        if (static_cast<size_t>(wpos) + bytes > wbuf.size()) {
+            failed = true;
+            return;
+        }
+
+        if constexpr (E == std::endian::native || sizeof(T) == 1)
+            std::memcpy(&wbuf[wpos], values.data(), bytes);
+        else
+            scanByteSwap(&wbuf[wpos], reinterpret_cast<const uint8_t*>(values.data()), sizeof(T), values.size());
+        wpos += bytes;
+    }
+
+    // Write a struct field by field, like ByteBuffer::put(obj). Dropped if it doesn't fit
+    template<std::endian E = std::endian::native, bb_reflect::Aggregate T> void put(const T& obj) {
+        constexpr size_t bytes = bb_reflect::encodedSize<T>();
+        if (static_cast<size_t>(wpos) + bytes > wbuf.size()) {
+            failed = true;
+            return;
+        }
+
+        bb_reflect::encode<E>(&wbuf[wpos], obj);
+        wpos += bytes;
+    }
+
+    // Write with an explicit byte order, ie. putInt<BB_NETWORK_ORDER>(value)
+
+    template<std::endian E> void putDouble(double value) { append<double>(endianConvert<E>(value)); }
+    template<std::endian E> void putDouble(double value, bb_size_t index) { insert<double>(endianConvert<E>(value), index); }
+    template<std::endian E> void putFloat(float value) { append<float>(endianConvert<E>(value)); }
+    template<std::endian E> void putFloat(float value, bb_size_t index) { insert<float>(endianConvert<E>(value), index); }
+    template<std::endian E> void putInt(uint32_t value) { append<uint32_t>(endianConvert<E>(value)); }
+    template<std::endian E> void putInt(uint32_t value, bb_size_t index) { insert<uint32_t>(endianConvert<E>(value), index); }
+    template<std::endian E> void putLong(uint64_t value) { append<uint64_t>(endianConvert<E>(value)); }
+    template<std::endian E> void putLong(uint64_t value, bb_size_t index) { insert<uint64_t>(endianConvert<E>(value), index); }
+    template<std::endian E> void putShort(uint16_t value) { append<uint16_t>(endianConvert<E>(value)); }
+    template<std::endian E> void putShort(uint16_t value, bb_size_t index) { insert<uint16_t>(endianConvert<E>(value), index); }
+
+    // Write Position Accessors & Mutators
+
+    void setWritePos(bb_size_t w) {
+        wpos = w;
+    }
+
+    bb_size_t getWritePos() const {
+        return wpos;
+    }
+
+protected:
+    std::span<uint8_t> wbuf;
+    bb_size_t wpos = 0;
+
+    template<typename T> void append(T data) {
+        insert<T>(data, wpos);
+    }
+
+    template<typename T> void insert(T data, bb_size_t index) {
+        if (static_cast<size_t>(index) + sizeof(T) > wbuf.size()) {
+            failed = true;
+            return;
+        }
+
+        std::memcpy(&wbuf[index], &data, sizeof(T));
+        wpos = index + sizeof(T);
+    }
+};
+
+#ifdef BB_USE_NS
+}
+#endif
+
+#endif
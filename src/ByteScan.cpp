@@ -0,0 +1,636 @@
+/**
+ ByteBuffer
+ ByteScan.cpp
+ Copyright 2011-2025 Ramsey Kant
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "ByteScan.hpp"
+
+#include <array>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BB_SCAN_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// AVX2 and SSE4.2 kernels are compiled with a per-function target attribute and picked at runtime, so the library itself
+// can still be built for (and run on) baseline x86-64
+#if defined(BB_SCAN_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define BB_SCAN_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+#ifdef BB_USE_NS
+namespace bb {
+#endif
+
+#ifdef BB_SCAN_DISPATCH
+static bool cpuHasAvx2() {
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+
+static bool cpuHasSse42() {
+    static const bool sse42 = __builtin_cpu_supports("sse4.2");
+    return sse42;
+}
+
+static bool cpuHasSsse3() {
+    static const bool ssse3 = __builtin_cpu_supports("ssse3");
+    return ssse3;
+}
+#endif
+
+template<typename T> static T loadLE(const uint8_t* p) {
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    if constexpr (std::endian::native == std::endian::big)
+        v = std::byteswap(v);
+    return v;
+}
+
+/**
+ * Find Bytes (Scalar)
+ * memchr for the first byte of the needle, then compare the rest. Used for the tail that's too short for a vector
+ * and on platforms without a SIMD kernel
+ */
+static int64_t findBytesScalar(const uint8_t* data, size_t len, const uint8_t* needle, size_t needleLen, size_t from) {
+    const size_t last = len - needleLen; // Last offset a match can start at
+    size_t i = from;
+    while (i <= last) {
+        auto hit = static_cast<const uint8_t*>(std::memchr(data + i, needle[0], last - i + 1));
+        if (hit == nullptr)
+            return -1;
+
+        i = hit - data;
+        if (std::memcmp(data + i + 1, needle + 1, needleLen - 1) == 0)
+            return static_cast<int64_t>(i);
+        i++;
+    }
+    return -1;
+}
+
+#ifdef BB_SCAN_SSE2
+/**
+ * Find Bytes (SSE2)
+ * Compare 16 candidate positions at once against both the first and last byte of the needle and only memcmp the
+ * positions where both match. Returns the offset scanning stopped at through 'next' when nothing was found
+ */
+static int64_t findBytesSse2(const uint8_t* data, size_t len, const uint8_t* needle, size_t needleLen, size_t& next) {
+    const __m128i first = _mm_set1_epi8(static_cast<char>(needle[0]));
+    const __m128i last = _mm_set1_epi8(static_cast<char>(needle[needleLen - 1]));
+
+    size_t i = 0;
+    for (; i + needleLen - 1 + 16 <= len; i += 16) {
+        const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + needleLen - 1));
+        auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first),
+                                                                          _mm_cmpeq_epi8(blockLast, last))));
+        while (mask != 0) {
+            const size_t pos = i + std::countr_zero(mask);
+            if (std::memcmp(data + pos + 1, needle + 1, needleLen - 2) == 0)
+                return static_cast<int64_t>(pos);
+            mask &= mask - 1;
+        }
+    }
+    next = i;
+    return -1;
+}
+#endif
+
+#ifdef BB_SCAN_DISPATCH
+/**
+ * Find Bytes (AVX2)
+ * Same first/last byte filter as the SSE2 kernel, 32 candidate positions at a time
+ */
+__attribute__((target("avx2")))
+static int64_t findBytesAvx2(const uint8_t* data, size_t len, const uint8_t* needle, size_t needleLen, size_t& next) {
+    const __m256i first = _mm256_set1_epi8(static_cast<char>(needle[0]));
+    const __m256i last = _mm256_set1_epi8(static_cast<char>(needle[needleLen - 1]));
+
+    size_t i = 0;
+    for (; i + needleLen - 1 + 32 <= len; i += 32) {
+        const __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + needleLen - 1));
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first),
+                                                                                _mm256_cmpeq_epi8(blockLast, last))));
+        while (mask != 0) {
+            const size_t pos = i + std::countr_zero(mask);
+            if (std::memcmp(data + pos + 1, needle + 1, needleLen - 2) == 0)
+                return static_cast<int64_t>(pos);
+            mask &= mask - 1;
+        }
+    }
+    next = i;
+    return -1;
+}
+#endif
+
+/**
+ * Find Byte
+ * Locate a single byte. libc's memchr is already vectorized on every platform we care about, so defer to it
+ *
+ * @param data Memory to search
+ * @param len Length of data
+ * @param key Byte to find
+ * @return Offset of the first occurrence of key, -1 if not found
+ */
+int64_t scanFindByte(const uint8_t* data, size_t len, uint8_t key) {
+    if (len == 0)
+        return -1;
+
+    auto hit = static_cast<const uint8_t*>(std::memchr(data, key, len));
+    return hit == nullptr ? -1 : static_cast<int64_t>(hit - data);
+}
+
+/**
+ * Find Bytes
+ * Locate a multi-byte pattern using a SIMD first/last byte filter, falling back to a memchr driven scalar search
+ * for the tail of the buffer
+ *
+ * @param data Memory to search
+ * @param len Length of data
+ * @param needle Byte pattern to find
+ * @param needleLen Length of the pattern
+ * @return Offset of the first occurrence of needle, -1 if not found
+ */
+int64_t scanFindBytes(const uint8_t* data, size_t len, const uint8_t* needle, size_t needleLen) {
+    if (needleLen == 0)
+        return 0;
+    if (needleLen > len)
+        return -1;
+    if (needleLen == 1)
+        return scanFindByte(data, len, needle[0]);
+
+    size_t next = 0;
+#ifdef BB_SCAN_DISPATCH
+    if (cpuHasAvx2()) {
+        int64_t pos = findBytesAvx2(data, len, needle, needleLen, next);
+        if (pos >= 0)
+            return pos;
+        return findBytesScalar(data, len, needle, needleLen, next);
+    }
+#endif
+#ifdef BB_SCAN_SSE2
+    int64_t pos = findBytesSse2(data, len, needle, needleLen, next);
+    if (pos >= 0)
+        return pos;
+#endif
+    return findBytesScalar(data, len, needle, needleLen, next);
+}
+
+#ifdef BB_SCAN_SSE2
+static int64_t findEolSse2(const uint8_t* data, size_t len, size_t& next) {
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const uint32_t mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, cr), _mm_cmpeq_epi8(block, lf)));
+        if (mask != 0)
+            return static_cast<int64_t>(i + std::countr_zero(mask));
+    }
+    next = i;
+    return -1;
+}
+#endif
+
+#ifdef BB_SCAN_DISPATCH
+__attribute__((target("avx2")))
+static int64_t findEolAvx2(const uint8_t* data, size_t len, size_t& next) {
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const uint32_t mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(block, cr), _mm256_cmpeq_epi8(block, lf)));
+        if (mask != 0)
+            return static_cast<int64_t>(i + std::countr_zero(mask));
+    }
+    next = i;
+    return -1;
+}
+#endif
+
+/**
+ * Find End of Line
+ * Locate the first CR or LF. Both bytes are compared a full vector at a time and the match mask gives the offset
+ * directly, so header blocks are split into lines without a per-byte loop
+ *
+ * @param data Memory to search
+ * @param len Length of data
+ * @return Offset of the first CR or LF, -1 if there is none
+ */
+int64_t scanFindEol(const uint8_t* data, size_t len) {
+    size_t i = 0;
+#if defined(BB_SCAN_DISPATCH)
+    const int64_t pos = cpuHasAvx2() ? findEolAvx2(data, len, i) : findEolSse2(data, len, i);
+    if (pos >= 0)
+        return pos;
+#elif defined(BB_SCAN_SSE2)
+    const int64_t pos = findEolSse2(data, len, i);
+    if (pos >= 0)
+        return pos;
+#endif
+    for (; i < len; i++) {
+        if (data[i] == '\r' || data[i] == '\n')
+            return static_cast<int64_t>(i);
+    }
+    return -1;
+}
+
+#ifdef BB_SCAN_SSE2
+static void replaceByteSse2(uint8_t* data, size_t len, uint8_t key, uint8_t rep, size_t& next) {
+    const __m128i vkey = _mm_set1_epi8(static_cast<char>(key));
+    const __m128i vrep = _mm_set1_epi8(static_cast<char>(rep));
+
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        auto p = reinterpret_cast<__m128i*>(data + i);
+        const __m128i block = _mm_loadu_si128(p);
+        const __m128i match = _mm_cmpeq_epi8(block, vkey);
+        _mm_storeu_si128(p, _mm_or_si128(_mm_andnot_si128(match, block), _mm_and_si128(match, vrep)));
+    }
+    next = i;
+}
+#endif
+
+#ifdef BB_SCAN_DISPATCH
+__attribute__((target("avx2")))
+static void replaceByteAvx2(uint8_t* data, size_t len, uint8_t key, uint8_t rep, size_t& next) {
+    const __m256i vkey = _mm256_set1_epi8(static_cast<char>(key));
+    const __m256i vrep = _mm256_set1_epi8(static_cast<char>(rep));
+
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        auto p = reinterpret_cast<__m256i*>(data + i);
+        const __m256i block = _mm256_loadu_si256(p);
+        _mm256_storeu_si256(p, _mm256_blendv_epi8(block, vrep, _mm256_cmpeq_epi8(block, vkey)));
+    }
+    next = i;
+}
+#endif
+
+/**
+ * Replace Byte
+ * Blend rep into every position equal to key, a full vector at a time. Every byte is visited, including zeroes
+ *
+ * @param data Memory to modify in place
+ * @param len Length of data
+ * @param key Byte to find for replacement
+ * @param rep Byte to replace the found key with
+ */
+void scanReplaceByte(uint8_t* data, size_t len, uint8_t key, uint8_t rep) {
+    size_t i = 0;
+#if defined(BB_SCAN_DISPATCH)
+    if (cpuHasAvx2())
+        replaceByteAvx2(data, len, key, rep, i);
+    else
+        replaceByteSse2(data, len, key, rep, i);
+#elif defined(BB_SCAN_SSE2)
+    replaceByteSse2(data, len, key, rep, i);
+#endif
+    for (; i < len; i++) {
+        if (data[i] == key)
+            data[i] = rep;
+    }
+}
+
+/**
+ * Replace Any
+ * Replace every byte that belongs to a set of keys. Small sets are handled with one vector compare per key,
+ * larger ones are turned into a translation table
+ *
+ * @param data Memory to modify in place
+ * @param len Length of data
+ * @param keys Set of bytes to replace
+ * @param numKeys Number of bytes in keys
+ * @param rep Byte to replace any found key with
+ */
+void scanReplaceAny(uint8_t* data, size_t len, const uint8_t* keys, size_t numKeys, uint8_t rep) {
+    constexpr size_t MAX_VECTOR_KEYS = 4;
+
+    if (numKeys == 0)
+        return;
+    if (numKeys == 1) {
+        scanReplaceByte(data, len, keys[0], rep);
+        return;
+    }
+
+    if (numKeys > MAX_VECTOR_KEYS) {
+        std::array<uint8_t, 256> table;
+        for (size_t b = 0; b < table.size(); b++)
+            table[b] = static_cast<uint8_t>(b);
+        for (size_t k = 0; k < numKeys; k++)
+            table[keys[k]] = rep;
+        scanTranslate(data, len, table);
+        return;
+    }
+
+    size_t i = 0;
+#ifdef BB_SCAN_SSE2
+    __m128i vkeys[MAX_VECTOR_KEYS];
+    for (size_t k = 0; k < numKeys; k++)
+        vkeys[k] = _mm_set1_epi8(static_cast<char>(keys[k]));
+    const __m128i vrep = _mm_set1_epi8(static_cast<char>(rep));
+
+    for (; i + 16 <= len; i += 16) {
+        auto p = reinterpret_cast<__m128i*>(data + i);
+        const __m128i block = _mm_loadu_si128(p);
+        __m128i match = _mm_cmpeq_epi8(block, vkeys[0]);
+        for (size_t k = 1; k < numKeys; k++)
+            match = _mm_or_si128(match, _mm_cmpeq_epi8(block, vkeys[k]));
+        _mm_storeu_si128(p, _mm_or_si128(_mm_andnot_si128(match, block), _mm_and_si128(match, vrep)));
+    }
+#endif
+    for (; i < len; i++) {
+        for (size_t k = 0; k < numKeys; k++) {
+            if (data[i] == keys[k]) {
+                data[i] = rep;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Translate
+ * Apply a 256 entry byte translation table. There's no profitable vector form of a full byte LUT on SSE2/AVX2,
+ * so the loop is unrolled to keep several independent loads in flight instead
+ *
+ * @param data Memory to modify in place
+ * @param len Length of data
+ * @param table Translation table, indexed by the original byte value
+ */
+void scanTranslate(uint8_t* data, size_t len, const std::array<uint8_t, 256>& table) {
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        const uint8_t b0 = table[data[i]], b1 = table[data[i + 1]], b2 = table[data[i + 2]], b3 = table[data[i + 3]];
+        const uint8_t b4 = table[data[i + 4]], b5 = table[data[i + 5]], b6 = table[data[i + 6]], b7 = table[data[i + 7]];
+        data[i] = b0; data[i + 1] = b1; data[i + 2] = b2; data[i + 3] = b3;
+        data[i + 4] = b4; data[i + 5] = b5; data[i + 6] = b6; data[i + 7] = b7;
+    }
+    for (; i < len; i++)
+        data[i] = table[data[i]];
+}
+
+// Byte order conversion
+
+// pshufb control that reverses every width byte lane of a 16 byte block
+static std::array<uint8_t, 16> swapShuffle(size_t width) {
+    std::array<uint8_t, 16> ctl{};
+    for (size_t i = 0; i < 16; i++)
+        ctl[i] = static_cast<uint8_t>((i / width) * width + (width - 1 - i % width));
+    return ctl;
+}
+
+#ifdef BB_SCAN_DISPATCH
+__attribute__((target("avx2")))
+static size_t byteSwapAvx2(uint8_t* dst, const uint8_t* src, size_t len, size_t width) {
+    const auto ctl = swapShuffle(width);
+    const __m256i mask = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctl.data())));
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(block, mask));
+    }
+    return i;
+}
+
+__attribute__((target("ssse3")))
+static size_t byteSwapSsse3(uint8_t* dst, const uint8_t* src, size_t len, size_t width) {
+    const auto ctl = swapShuffle(width);
+    const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctl.data()));
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(block, mask));
+    }
+    return i;
+}
+#endif
+
+template<typename T> static void byteSwapScalar(uint8_t* dst, const uint8_t* src, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        T v;
+        std::memcpy(&v, src + i * sizeof(T), sizeof(T));
+        v = std::byteswap(v);
+        std::memcpy(dst + i * sizeof(T), &v, sizeof(T));
+    }
+}
+
+/**
+ * Byte Swap
+ * Copy an array of 2, 4 or 8 byte elements while reversing the bytes of each one. On x86-64 whole vectors are
+ * permuted with a single pshufb (SSSE3) or vpshufb (AVX2) when the CPU supports it; the rest is swapped one element
+ * at a time
+ *
+ * @param dst Destination, count * width bytes
+ * @param src Source, count * width bytes
+ * @param width Size of each element in bytes
+ * @param count Number of elements
+ */
+void scanByteSwap(uint8_t* dst, const uint8_t* src, size_t width, size_t count) {
+    const size_t len = width * count;
+    if (width <= 1) {
+        std::memcpy(dst, src, len);
+        return;
+    }
+
+    size_t done = 0;
+#ifdef BB_SCAN_DISPATCH
+    if (16 % width == 0) {
+        if (cpuHasAvx2())
+            done = byteSwapAvx2(dst, src, len, width);
+        else if (cpuHasSsse3())
+            done = byteSwapSsse3(dst, src, len, width);
+    }
+#endif
+
+    // done is a multiple of 16, so it always ends on an element boundary
+    dst += done;
+    src += done;
+    count -= done / width;
+    switch (width) {
+    case 2:
+        byteSwapScalar<uint16_t>(dst, src, count);
+        break;
+    case 4:
+        byteSwapScalar<uint32_t>(dst, src, count);
+        break;
+    case 8:
+        byteSwapScalar<uint64_t>(dst, src, count);
+        break;
+    default:
+        for (size_t e = 0; e < count; e++) {
+            for (size_t b = 0; b < width; b++)
+                dst[e * width + b] = src[e * width + width - 1 - b];
+        }
+        break;
+    }
+}
+
+// Hashing
+
+constexpr uint64_t XXH_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t XXH_PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t XXH_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t XXH_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t xxhRound(uint64_t acc, uint64_t input) {
+    acc += input * XXH_PRIME64_2;
+    acc = std::rotl(acc, 31);
+    return acc * XXH_PRIME64_1;
+}
+
+static inline uint64_t xxhMergeRound(uint64_t acc, uint64_t val) {
+    acc ^= xxhRound(0, val);
+    return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+/**
+ * Hash64
+ * xxHash64 of a block of memory. Four independent 64-bit lanes consume 32 bytes per iteration, so the loop runs at
+ * several bytes per cycle without needing SIMD
+ *
+ * @param data Memory to hash
+ * @param len Length of data
+ * @param seed Seed value. Hashing the same bytes with different seeds gives unrelated results
+ * @return 64-bit hash
+ */
+uint64_t scanHash64(const uint8_t* data, size_t len, uint64_t seed) {
+    const uint8_t* p = data;
+    const uint8_t* const end = data + len;
+    uint64_t h;
+
+    if (len >= 32) {
+        uint64_t v1 = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+        uint64_t v2 = seed + XXH_PRIME64_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - XXH_PRIME64_1;
+        const uint8_t* const limit = end - 32;
+        do {
+            v1 = xxhRound(v1, loadLE<uint64_t>(p));
+            v2 = xxhRound(v2, loadLE<uint64_t>(p + 8));
+            v3 = xxhRound(v3, loadLE<uint64_t>(p + 16));
+            v4 = xxhRound(v4, loadLE<uint64_t>(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        h = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+        h = xxhMergeRound(h, v1);
+        h = xxhMergeRound(h, v2);
+        h = xxhMergeRound(h, v3);
+        h = xxhMergeRound(h, v4);
+    } else {
+        h = seed + XXH_PRIME64_5;
+    }
+
+    h += static_cast<uint64_t>(len);
+
+    for (; p + 8 <= end; p += 8) {
+        h ^= xxhRound(0, loadLE<uint64_t>(p));
+        h = std::rotl(h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(loadLE<uint32_t>(p)) * XXH_PRIME64_1;
+        h = std::rotl(h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        h ^= (*p) * XXH_PRIME64_5;
+        h = std::rotl(h, 11) * XXH_PRIME64_1;
+    }
+
+    h ^= h >> 33;
+    h *= XXH_PRIME64_2;
+    h ^= h >> 29;
+    h *= XXH_PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+// CRC-32C
+
+// Slicing-by-8 tables for the reflected Castagnoli polynomial, built at compile time
+static constexpr std::array<std::array<uint32_t, 256>, 8> CRC32C_TABLES = [] {
+    constexpr uint32_t POLY = 0x82F63B78u;
+    std::array<std::array<uint32_t, 256>, 8> t{};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int32_t k = 0; k < 8; k++)
+            c = (c >> 1) ^ ((c & 1) ? POLY : 0);
+        t[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (size_t s = 1; s < t.size(); s++)
+            t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFF];
+    }
+    return t;
+}();
+
+static uint32_t crc32cSlicing8(const uint8_t* p, size_t len, uint32_t c) {
+    const auto& t = CRC32C_TABLES;
+    for (; len >= 8; len -= 8, p += 8) {
+        const uint32_t lo = loadLE<uint32_t>(p) ^ c;
+        const uint32_t hi = loadLE<uint32_t>(p + 4);
+        c = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+            t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+    }
+    for (; len > 0; len--, p++)
+        c = (c >> 8) ^ t[0][(c ^ *p) & 0xFF];
+    return c;
+}
+
+#ifdef BB_SCAN_DISPATCH
+__attribute__((target("sse4.2")))
+static uint32_t crc32cSse42(const uint8_t* p, size_t len, uint32_t c) {
+    uint64_t c64 = c;
+    for (; len >= 8; len -= 8, p += 8)
+        c64 = _mm_crc32_u64(c64, loadLE<uint64_t>(p));
+    c = static_cast<uint32_t>(c64);
+    for (; len > 0; len--, p++)
+        c = _mm_crc32_u8(c, *p);
+    return c;
+}
+#endif
+
+/**
+ * CRC-32C
+ * Castagnoli CRC (as used by iSCSI, SCTP, ext4, ...). Uses the SSE4.2 crc32 instruction when the CPU has it,
+ * otherwise a slicing-by-8 table implementation
+ *
+ * @param data Memory to checksum
+ * @param len Length of data
+ * @param crc CRC of the preceding bytes when continuing a running checksum, 0 to start a new one
+ * @return CRC-32C of the preceding bytes (if any) followed by data[0, len)
+ */
+uint32_t scanCrc32c(const uint8_t* data, size_t len, uint32_t crc) {
+    const uint32_t c = ~crc;
+#ifdef BB_SCAN_DISPATCH
+    if (cpuHasSse42())
+        return ~crc32cSse42(data, len, c);
+#endif
+    return ~crc32cSlicing8(data, len, c);
+}
+
+#ifdef BB_USE_NS
+}
+#endif
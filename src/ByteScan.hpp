@@ -0,0 +1,68 @@
+/**
+ ByteBuffer
+ ByteScan.hpp
+ Copyright 2011-2025 Ramsey Kant
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef _BYTESCAN_H_
+#define _BYTESCAN_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Bulk scanning kernels shared by ByteBuffer and ByteBufferView. They work on raw memory, have no notion of
+// read/write positions and never treat a zero byte as a terminator.
+// On x86-64 the SSE2 paths are always compiled in, and AVX2 paths are selected at runtime when the CPU supports them
+
+#ifdef BB_USE_NS
+namespace bb {
+#endif
+
+// Offset of the first occurrence of key in data[0, len). -1 if not found
+int64_t scanFindByte(const uint8_t* data, size_t len, uint8_t key);
+
+// Offset of the first occurrence of the byte sequence needle[0, needleLen) in data[0, len). -1 if not found.
+// An empty needle is found at offset 0
+int64_t scanFindBytes(const uint8_t* data, size_t len, const uint8_t* needle, size_t needleLen);
+
+// Offset of the first CR or LF in data[0, len), ie. the end of a text line. -1 if there is none
+int64_t scanFindEol(const uint8_t* data, size_t len);
+
+// Replace every occurrence of key in data[0, len) with rep
+void scanReplaceByte(uint8_t* data, size_t len, uint8_t key, uint8_t rep);
+
+// Replace every byte in data[0, len) that matches any of keys[0, numKeys) with rep
+void scanReplaceAny(uint8_t* data, size_t len, const uint8_t* keys, size_t numKeys, uint8_t rep);
+
+// Map every byte b in data[0, len) to table[b]
+void scanTranslate(uint8_t* data, size_t len, const std::array<uint8_t, 256>& table);
+
+// Copy count elements of width (1, 2, 4 or 8) bytes from src to dst, reversing the byte order of each element.
+// dst and src must not overlap
+void scanByteSwap(uint8_t* dst, const uint8_t* src, size_t width, size_t count);
+
+// 64-bit non-cryptographic hash of data[0, len) (xxHash64 algorithm)
+uint64_t scanHash64(const uint8_t* data, size_t len, uint64_t seed);
+
+// CRC-32C (Castagnoli) of data[0, len). Pass the CRC of the preceding bytes as crc to continue a running checksum,
+// 0 to start a new one
+uint32_t scanCrc32c(const uint8_t* data, size_t len, uint32_t crc);
+
+#ifdef BB_USE_NS
+}
+#endif
+
+#endif
@@ -0,0 +1,148 @@
+/**
+ ByteBuffer
+ ConstByteBuffer.hpp
+ Copyright 2011-2025 Ramsey Kant
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef _CONSTBYTEBUFFER_H_
+#define _CONSTBYTEBUFFER_H_
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "ByteBuffer.hpp"
+
+#ifdef BB_USE_NS
+namespace bb {
+#endif
+
+// Write-only buffer of at most N bytes that works in constant expressions, for building fixed byte sequences
+// (handshakes, canned responses, static headers) at compile time instead of on every send:
+//     static constexpr auto hello = [] {
+//         ConstByteBuffer<16> b;
+//         b.putShort<BB_NETWORK_ORDER>(0x0001);
+//         b.putString("HELO");
+//         return b;
+//     }();
+//     static_assert(hello.ok());
+//     out.putBytes(hello.data(), hello.size());
+// Writes that don't fit in N bytes are dropped and clear ok(), so an undersized N can be caught with a static_assert
+template<bb_size_t N> class ConstByteBuffer {
+public:
+    constexpr ConstByteBuffer() = default;
+
+    constexpr bb_size_t size() const { // Bytes written so far
+        return wpos;
+    }
+    static constexpr bb_size_t capacity() {
+        return N;
+    }
+    constexpr bool ok() const { // False once a write has been dropped for not fitting
+        return !failed;
+    }
+
+    constexpr const uint8_t* data() const {
+        return buf.data();
+    }
+    constexpr std::span<const uint8_t> bytes() const { // The bytes written so far
+        return std::span<const uint8_t>(buf.data(), wpos);
+    }
+    std::string_view str() const { // The bytes written so far, as text. Runtime only (needs a reinterpret_cast)
+        return std::string_view(reinterpret_cast<const char*>(buf.data()), wpos);
+    }
+    constexpr uint8_t operator[](bb_size_t index) const {
+        return buf[index];
+    }
+
+    // Copy of the first M bytes as an exactly-sized array, ie. toArray<hello.size()>() for a constexpr array with no
+    // unused tail
+    template<bb_size_t M> constexpr std::array<uint8_t, M> toArray() const {
+        static_assert(M <= N, "toArray can't return more bytes than the buffer holds");
+        std::array<uint8_t, M> out{};
+        for (bb_size_t i = 0; i < M; i++)
+            out[i] = buf[i];
+        return out;
+    }
+
+    // Write
+
+    constexpr void put(uint8_t b) { append<uint8_t>(b); }
+    constexpr void putBytes(const uint8_t* const b, bb_size_t len) {
+        if (!reserve(len))
+            return;
+        for (bb_size_t i = 0; i < len; i++)
+            buf[wpos++] = b[i];
+    }
+    constexpr void putBytes(std::span<const uint8_t> b) { putBytes(b.data(), static_cast<bb_size_t>(b.size())); }
+    constexpr void putChar(char value) { append<char>(value); }
+    constexpr void putDouble(double value) { append<double>(value); }
+    constexpr void putFloat(float value) { append<float>(value); }
+    constexpr void putInt(uint32_t value) { append<uint32_t>(value); }
+    constexpr void putLong(uint64_t value) { append<uint64_t>(value); }
+    constexpr void putShort(uint16_t value) { append<uint16_t>(value); }
+
+    // Text without a terminating null. putLine() ends the text with CRLF, like HTTPMessage::putLine()
+    constexpr void putString(std::string_view str) {
+        if (!reserve(str.size()))
+            return;
+        for (char c : str)
+            buf[wpos++] = static_cast<uint8_t>(c);
+    }
+    constexpr void putLine(std::string_view str = "", bool crlf_end = true) {
+        putString(str);
+        if (crlf_end)
+            putString("\r\n");
+    }
+
+    // Write with an explicit byte order, ie. putInt<BB_NETWORK_ORDER>(value)
+
+    template<std::endian E> constexpr void putDouble(double value) { append<double>(endianConvert<E>(value)); }
+    template<std::endian E> constexpr void putFloat(float value) { append<float>(endianConvert<E>(value)); }
+    template<std::endian E> constexpr void putInt(uint32_t value) { append<uint32_t>(endianConvert<E>(value)); }
+    template<std::endian E> constexpr void putLong(uint64_t value) { append<uint64_t>(endianConvert<E>(value)); }
+    template<std::endian E> constexpr void putShort(uint16_t value) { append<uint16_t>(endianConvert<E>(value)); }
+
+private:
+    std::array<uint8_t, N> buf{};
+    bb_size_t wpos = 0;
+    bool failed = false;
+
+    constexpr bool reserve(size_t len) {
+        if (static_cast<size_t>(wpos) + len > N) {
+            failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    // memcpy isn't usable in constant expressions, so the value's bytes are taken with bit_cast
+    template<typename T> constexpr void append(T data) {
+        if (!reserve(sizeof(T)))
+            return;
+        const auto raw = std::bit_cast<std::array<uint8_t, sizeof(T)>>(data);
+        for (size_t i = 0; i < sizeof(T); i++)
+            buf[wpos++] = raw[i];
+    }
+};
+
+#ifdef BB_USE_NS
+}
+#endif
+
+#endif
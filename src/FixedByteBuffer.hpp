@@ -0,0 +1,184 @@
+/**
+ ByteBuffer
+ FixedByteBuffer.hpp
+ Copyright 2011-2025 Ramsey Kant
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef _FIXEDBYTEBUFFER_H_
+#define _FIXEDBYTEBUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+#include "ByteBuffer.hpp"
+
+#ifdef BB_USE_NS
+namespace bb {
+#endif
+
+// Inline arena of a FixedByteBuffer. A separate base so that it is constructed before, and destroyed after, the
+// ByteBuffer that allocates from it
+template<bb_size_t N> class FixedByteBufferArena {
+protected:
+    // Inline bytes reserved on top of N for the buffer's bookkeeping (the shared storage header and its control block)
+    static constexpr size_t OVERHEAD = 128;
+
+    explicit FixedByteBufferArena(std::pmr::memory_resource* upstream) : arena(bytes, sizeof(bytes), upstream) {}
+
+    alignas(std::max_align_t) std::byte bytes[N + OVERHEAD];
+    std::pmr::monotonic_buffer_resource arena;
+};
+
+// ByteBuffer with room for N bytes stored inside the object itself, so a small packet built on the stack makes no
+// heap allocations at all. Past N bytes the storage spills to the upstream resource and keeps working as a normal
+// ByteBuffer. The ByteBuffer read/write API is available and every call is resolved statically.
+// The ByteBuffer base is private: a ByteBuffer copied or moved out of it would share storage inside this object and
+// dangle once it is destroyed, so that conversion doesn't compile. toByteBuffer() makes an owning copy, and buffer()
+// lends the object to functions that take a ByteBuffer&.
+// Memory given up by growth or copy-on-write is only reclaimed when the FixedByteBuffer is destroyed
+template<bb_size_t N> class FixedByteBuffer final : private FixedByteBufferArena<N>, private ByteBuffer {
+public:
+    /**
+     * FixedByteBuffer constructor
+     *
+     * @param upstream Resource used once more than N bytes are needed. Pass std::pmr::null_memory_resource() to
+     *                 forbid heap allocation entirely (writing past N then throws std::bad_alloc)
+     */
+    explicit FixedByteBuffer(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : FixedByteBufferArena<N>(upstream), ByteBuffer(N, &this->arena) {}
+
+    /**
+     * FixedByteBuffer constructor
+     * Copy len bytes of arr into the buffer
+     *
+     * @param arr Bytes to copy
+     * @param len Length of arr
+     * @param upstream Resource used once more than N bytes are needed
+     */
+    FixedByteBuffer(const uint8_t* arr, bb_size_t len, std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : FixedByteBuffer(upstream) {
+        putBytes(arr, len);
+    }
+
+    // The bytes live inside the object, so it can be neither copied nor moved. Use toByteBuffer() for a copy that can
+    // outlive it
+    FixedByteBuffer(const FixedByteBuffer&) = delete;
+    FixedByteBuffer& operator=(const FixedByteBuffer&) = delete;
+
+    // The object as a ByteBuffer, to pass to functions taking a ByteBuffer& or ByteBuffer*. Don't copy it, or
+    // clone()/duplicate()/slice() it: those share the inline bytes and must not outlive this object
+    ByteBuffer& buffer() {
+        return *this;
+    }
+    const ByteBuffer& buffer() const {
+        return *this;
+    }
+
+    // ByteBuffer API, minus the copies that would share the inline bytes (copy/move, clone(), duplicate(), slice())
+    using ByteBuffer::bytesRemaining;
+    using ByteBuffer::clear;
+    using ByteBuffer::equals;
+    using ByteBuffer::resize;
+    using ByteBuffer::compact;
+    using ByteBuffer::flip;
+    using ByteBuffer::size;
+    using ByteBuffer::capacity;
+    using ByteBuffer::prepare;
+    using ByteBuffer::commit;
+#ifndef _WIN32
+    using ByteBuffer::getReadableIov;
+#endif
+    using ByteBuffer::ok;
+    using ByteBuffer::clearError;
+    using ByteBuffer::require;
+    using ByteBuffer::isShared;
+    using ByteBuffer::getMemoryResource;
+    using ByteBuffer::data;
+    using ByteBuffer::writableData;
+    using ByteBuffer::find;
+    using ByteBuffer::findBytes;
+    using ByteBuffer::findEol;
+    using ByteBuffer::hash64;
+    using ByteBuffer::crc32c;
+    using ByteBuffer::replace;
+    using ByteBuffer::replaceAny;
+    using ByteBuffer::translate;
+    using ByteBuffer::peek;
+    using ByteBuffer::get;
+    using ByteBuffer::getBytes;
+    using ByteBuffer::getChar;
+    using ByteBuffer::getDouble;
+    using ByteBuffer::getFloat;
+    using ByteBuffer::getInt;
+    using ByteBuffer::getLong;
+    using ByteBuffer::getShort;
+    using ByteBuffer::getArray;
+    using ByteBuffer::put;
+    using ByteBuffer::splice;
+    using ByteBuffer::putBytes;
+    using ByteBuffer::putChar;
+    using ByteBuffer::putDouble;
+    using ByteBuffer::putFloat;
+    using ByteBuffer::putInt;
+    using ByteBuffer::putLong;
+    using ByteBuffer::putShort;
+    using ByteBuffer::putArray;
+    using ByteBuffer::setReadPos;
+    using ByteBuffer::getReadPos;
+    using ByteBuffer::setWritePos;
+    using ByteBuffer::getWritePos;
+    using ByteBuffer::mark;
+    using ByteBuffer::reset;
+    using ByteBuffer::rewind;
+#ifdef BB_UTILITY
+    using ByteBuffer::setName;
+    using ByteBuffer::getName;
+    using ByteBuffer::printInfo;
+    using ByteBuffer::printAH;
+    using ByteBuffer::printAscii;
+    using ByteBuffer::printHex;
+    using ByteBuffer::printPosition;
+#endif
+
+    /**
+     * To ByteBuffer
+     * Deep copy of the contents and read/write positions, in storage of its own
+     *
+     * @param mr Resource the copy allocates from
+     * @return A ByteBuffer that doesn't depend on this object
+     */
+    ByteBuffer toByteBuffer(std::pmr::memory_resource* mr = std::pmr::get_default_resource()) const {
+        ByteBuffer out(data(), size(), mr);
+        out.setReadPos(getReadPos());
+        out.setWritePos(getWritePos());
+        return out;
+    }
+
+    static constexpr bb_size_t inlineCapacity() {
+        return N;
+    }
+
+    bool isInline() const { // True while the bytes are still stored inside the object
+        const std::byte* p = reinterpret_cast<const std::byte*>(data());
+        return p >= this->bytes && p < this->bytes + sizeof(this->bytes);
+    }
+};
+
+#ifdef BB_USE_NS
+}
+#endif
+
+#endif
@@ -0,0 +1,167 @@
+/**
+ ByteBuffer
+ MappedByteBuffer.cpp
+ Copyright 2011-2025 Ramsey Kant
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "MappedByteBuffer.hpp"
+
+#ifndef _WIN32
+
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef BB_USE_NS
+namespace bb {
+#endif
+
+/**
+ * MappedByteBuffer constructor
+ * Take ownership of an existing mapping. A read-only mapping gets an empty write span, so every put is dropped
+ *
+ * @param addr Start of the mapping. NULL for an empty file
+ * @param len Length of the mapping
+ * @param writable True if the mapping is writable
+ */
+MappedByteBuffer::MappedByteBuffer(uint8_t* addr, size_t len, bool writable)
+    : MutableByteBufferView(addr, len), addr(addr), mapLen(len), writable(writable) {
+    if (!writable)
+        wbuf = std::span<uint8_t>();
+}
+
+MappedByteBuffer::~MappedByteBuffer() {
+    if (addr != nullptr)
+        munmap(addr, mapLen);
+}
+
+/**
+ * Open
+ * Map an entire file into memory. No data is read until it is accessed
+ *
+ * @param path Path of the file to map
+ * @param mode ReadOnly, or ReadWrite to write changes back to the file
+ * @return The mapped file, or nullptr if the file couldn't be opened or mapped, or is too large for bb_size_t
+ */
+std::unique_ptr<MappedByteBuffer> MappedByteBuffer::open(const std::string& path, Mode mode) {
+    const bool rw = mode == Mode::ReadWrite;
+
+    int fd = ::open(path.c_str(), rw ? O_RDWR : O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 0
+        || static_cast<uint64_t>(st.st_size) > std::numeric_limits<bb_size_t>::max()) {
+        close(fd);
+        return nullptr;
+    }
+
+    // mmap() rejects a zero length, so an empty file gets an empty view instead
+    const size_t len = static_cast<size_t>(st.st_size);
+    uint8_t* addr = nullptr;
+    if (len > 0) {
+        void* m = mmap(nullptr, len, rw ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+        if (m == MAP_FAILED) {
+            close(fd);
+            return nullptr;
+        }
+        addr = static_cast<uint8_t*>(m);
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    close(fd);
+
+    return std::unique_ptr<MappedByteBuffer>(new MappedByteBuffer(addr, len, rw));
+}
+
+/**
+ * Sync
+ * Write modified pages back to the file
+ *
+ * @param wait If true, block until the data has been written. Otherwise just schedule the write
+ * @return True on success. False if the mapping is read-only or msync() failed
+ */
+bool MappedByteBuffer::sync(bool wait) {
+    if (!writable)
+        return false;
+    if (addr == nullptr)
+        return true;
+    return msync(addr, mapLen, wait ? MS_SYNC : MS_ASYNC) == 0;
+}
+
+/**
+ * Advise
+ * Tell the OS how the whole mapping is going to be accessed
+ *
+ * @param advice Expected access pattern
+ * @return True if the hint was accepted
+ */
+bool MappedByteBuffer::advise(Advice advice) {
+    return advise(advice, 0, mapLen);
+}
+
+/**
+ * Advise
+ * Tell the OS how part of the mapping is going to be accessed. The range is widened to whole pages
+ *
+ * @param advice Expected access pattern
+ * @param offset Start of the range
+ * @param len Length of the range. Clamped to the end of the mapping
+ * @return True if the hint was accepted
+ */
+bool MappedByteBuffer::advise(Advice advice, bb_size_t offset, bb_size_t len) {
+    if (addr == nullptr)
+        return true;
+    if (offset >= mapLen)
+        return false;
+    if (len > mapLen - offset)
+        len = mapLen - offset;
+
+    int flag = MADV_NORMAL;
+    switch (advice) {
+    case Advice::Normal:
+        flag = MADV_NORMAL;
+        break;
+    case Advice::Sequential:
+        flag = MADV_SEQUENTIAL;
+        break;
+    case Advice::Random:
+        flag = MADV_RANDOM;
+        break;
+    case Advice::WillNeed:
+        flag = MADV_WILLNEED;
+        break;
+    case Advice::DontNeed:
+        flag = MADV_DONTNEED;
+        break;
+    }
+
+    // madvise() needs a page aligned start
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t start = (static_cast<size_t>(offset) / page) * page;
+    const size_t end = static_cast<size_t>(offset) + len;
+
+    return madvise(addr + start, end - start, flag) == 0;
+}
+
+#ifdef BB_USE_NS
+}
+#endif
+
+#endif
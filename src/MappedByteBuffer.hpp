@@ -0,0 +1,91 @@
+/**
+ ByteBuffer
+ MappedByteBuffer.hpp
+ Copyright 2011-2025 Ramsey Kant
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef _MAPPEDBYTEBUFFER_H_
+#define _MAPPEDBYTEBUFFER_H_
+
+// mmap based, so only available on POSIX systems
+#ifndef _WIN32
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "ByteBufferView.hpp"
+
+#ifdef BB_USE_NS
+namespace bb {
+#endif
+
+// A file mapped into memory, with the ByteBufferView get/find API (and the put API when mapped read-write).
+// Opening only maps the file; pages are read in lazily by the OS as they are first touched.
+// Writes can't grow the file: like any MutableByteBufferView, writes past the end are dropped
+class MappedByteBuffer : public MutableByteBufferView {
+public:
+    enum class Mode {
+        ReadOnly,
+        ReadWrite // Changes are written back to the file (see sync())
+    };
+
+    // Access pattern hints passed on to madvise()
+    enum class Advice {
+        Normal,
+        Sequential, // Read ahead aggressively and drop pages soon after they are read
+        Random, // Don't read ahead
+        WillNeed, // Start reading the pages in now
+        DontNeed // Pages won't be needed again soon
+    };
+
+    static std::unique_ptr<MappedByteBuffer> open(const std::string& path, Mode mode = Mode::ReadOnly);
+
+    MappedByteBuffer(const MappedByteBuffer&) = delete;
+    MappedByteBuffer& operator=(const MappedByteBuffer&) = delete;
+    ~MappedByteBuffer();
+
+    bool isWritable() const {
+        return writable;
+    }
+
+    using MutableByteBufferView::data;
+
+    // Start of the mapping for writing, or nullptr if it is read-only (like a view with nothing writable). Read through
+    // the const overload, which returns the mapping address either way
+    uint8_t* data() {
+        return writable ? addr : nullptr;
+    }
+
+    bool sync(bool wait = true); // Flush changes to the file. Returns false on failure or if the mapping is read-only
+    bool advise(Advice advice); // Hint for the whole mapping
+    bool advise(Advice advice, bb_size_t offset, bb_size_t len); // Hint for the bytes [offset, offset+len)
+
+private:
+    MappedByteBuffer(uint8_t* addr, size_t len, bool writable);
+
+    uint8_t* addr = nullptr;
+    size_t mapLen = 0;
+    bool writable = false;
+};
+
+#ifdef BB_USE_NS
+}
+#endif
+
+#endif
+
+#endif
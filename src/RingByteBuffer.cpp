@@ -0,0 +1,211 @@
+/**
+ ByteBuffer
+ RingByteBuffer.cpp
+ Copyright 2011-2025 Ramsey Kant
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "RingByteBuffer.hpp"
+
+#ifdef BB_USE_NS
+namespace bb {
+#endif
+
+/**
+ * RingByteBuffer constructor
+ *
+ * @param capacity Minimum capacity in bytes. Rounded up to the next power of two (at least 8), and clamped to
+ *                 MAX_CAPACITY
+ */
+RingByteBuffer::RingByteBuffer(bb_size_t capacity) {
+    const bb_size_t cap = capacityFor(capacity);
+    buf = std::make_unique_for_overwrite<uint8_t[]>(cap);
+    mask = cap - 1;
+}
+
+/**
+ * Data
+ * The readable bytes, without consuming them. The second span is only non-empty when the bytes wrap around the end
+ * of the storage. The spans are invalidated by any write
+ *
+ * @return Spans covering the readable bytes, in order
+ */
+std::array<std::span<const uint8_t>, 2> RingByteBuffer::data() const {
+    const bb_size_t len = bytesRemaining();
+    const bb_size_t start = head & mask;
+    const bb_size_t first = len < capacity() - start ? len : capacity() - start;
+    return {std::span<const uint8_t>(buf.get() + start, first), std::span<const uint8_t>(buf.get(), len - first)};
+}
+
+/**
+ * Consume
+ * Drop bytes from the front of the buffer, ie. after parsing them in place through data()
+ *
+ * @param n Number of bytes to drop. Clamped to bytesRemaining()
+ */
+void RingByteBuffer::consume(bb_size_t n) {
+    head += n < bytesRemaining() ? n : bytesRemaining();
+}
+
+/**
+ * Prepare
+ * The free space, so a recv()/readv() can write into the buffer directly. The second span is only non-empty when
+ * the free space wraps around the end of the storage. Follow with commit()
+ *
+ * @return Spans covering the free space, in order
+ */
+std::array<std::span<uint8_t>, 2> RingByteBuffer::prepare() {
+    const bb_size_t len = bytesFree();
+    const bb_size_t start = tail & mask;
+    const bb_size_t first = len < capacity() - start ? len : capacity() - start;
+    return {std::span<uint8_t>(buf.get() + start, first), std::span<uint8_t>(buf.get(), len - first)};
+}
+
+/**
+ * Commit
+ * Make bytes written into the spans returned by prepare() readable
+ *
+ * @param n Number of bytes written. Clamped to bytesFree()
+ */
+void RingByteBuffer::commit(bb_size_t n) {
+    tail += n < bytesFree() ? n : bytesFree();
+}
+
+/**
+ * Write
+ * Append as much of src as fits
+ *
+ * @param src Bytes to append
+ * @param len Length of src
+ * @return Number of bytes appended
+ */
+bb_size_t RingByteBuffer::write(const uint8_t* src, bb_size_t len) {
+    if (len > bytesFree())
+        len = bytesFree();
+    copyIn(tail, src, len);
+    tail += len;
+    return len;
+}
+
+/**
+ * Read
+ * Consume up to len bytes into dst
+ *
+ * @param dst Destination, at least len bytes long
+ * @param len Maximum number of bytes to read
+ * @return Number of bytes read
+ */
+bb_size_t RingByteBuffer::read(uint8_t* dst, bb_size_t len) {
+    len = peek(dst, len);
+    head += len;
+    return len;
+}
+
+/**
+ * Peek
+ * Copy up to len bytes into dst without consuming them
+ *
+ * @param dst Destination, at least len bytes long
+ * @param len Maximum number of bytes to copy
+ * @param offset Number of readable bytes to skip before copying
+ * @return Number of bytes copied
+ */
+bb_size_t RingByteBuffer::peek(uint8_t* dst, bb_size_t len, bb_size_t offset) const {
+    const bb_size_t avail = bytesRemaining();
+    if (offset >= avail)
+        return 0;
+    if (len > avail - offset)
+        len = avail - offset;
+    copyOut(head + offset, dst, len);
+    return len;
+}
+
+// Copy len bytes starting at counter position from, in at most two pieces
+void RingByteBuffer::copyOut(bb_size_t from, uint8_t* dst, bb_size_t len) const {
+    const bb_size_t start = from & mask;
+    const bb_size_t first = len < capacity() - start ? len : capacity() - start;
+    std::memcpy(dst, buf.get() + start, first);
+    std::memcpy(dst + first, buf.get(), len - first);
+}
+
+void RingByteBuffer::copyIn(bb_size_t to, const uint8_t* src, bb_size_t len) {
+    const bb_size_t start = to & mask;
+    const bb_size_t first = len < capacity() - start ? len : capacity() - start;
+    std::memcpy(buf.get() + start, src, first);
+    std::memcpy(buf.get(), src + first, len - first);
+}
+
+// Read Functions
+
+uint8_t RingByteBuffer::get() {
+    return getValue<uint8_t>();
+}
+
+char RingByteBuffer::getChar() {
+    return getValue<char>();
+}
+
+double RingByteBuffer::getDouble() {
+    return getValue<double>();
+}
+
+float RingByteBuffer::getFloat() {
+    return getValue<float>();
+}
+
+uint32_t RingByteBuffer::getInt() {
+    return getValue<uint32_t>();
+}
+
+uint64_t RingByteBuffer::getLong() {
+    return getValue<uint64_t>();
+}
+
+uint16_t RingByteBuffer::getShort() {
+    return getValue<uint16_t>();
+}
+
+// Write Functions
+
+void RingByteBuffer::put(uint8_t b) {
+    putValue<uint8_t>(b);
+}
+
+void RingByteBuffer::putChar(char value) {
+    putValue<char>(value);
+}
+
+void RingByteBuffer::putDouble(double value) {
+    putValue<double>(value);
+}
+
+void RingByteBuffer::putFloat(float value) {
+    putValue<float>(value);
+}
+
+void RingByteBuffer::putInt(uint32_t value) {
+    putValue<uint32_t>(value);
+}
+
+void RingByteBuffer::putLong(uint64_t value) {
+    putValue<uint64_t>(value);
+}
+
+void RingByteBuffer::putShort(uint16_t value) {
+    putValue<uint16_t>(value);
+}
+
+#ifdef BB_USE_NS
+}
+#endif
@@ -0,0 +1,163 @@
+/**
+ ByteBuffer
+ RingByteBuffer.hpp
+ Copyright 2011-2025 Ramsey Kant
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef _RINGBYTEBUFFER_H_
+#define _RINGBYTEBUFFER_H_
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <span>
+
+#include "ByteBuffer.hpp"
+
+#ifdef BB_USE_NS
+namespace bb {
+#endif
+
+// Fixed-capacity circular byte queue for long lived connections. The capacity is a power of two, so positions wrap
+// with a mask and bytes are never moved: a value that crosses the end of the storage is read and written in two
+// pieces. Typed puts that don't fit and typed gets with too few bytes available do nothing (gets return 0) and set the
+// sticky error state (see ok()). Bulk transfers report short counts through their return value instead
+class RingByteBuffer {
+public:
+    explicit RingByteBuffer(bb_size_t capacity = BB_DEFAULT_SIZE); // Rounded up to a power of two
+
+    // Largest capacity: the biggest power of two a bb_size_t can hold
+    static constexpr bb_size_t MAX_CAPACITY = bb_size_t(1) << (std::numeric_limits<bb_size_t>::digits - 1);
+
+    // Capacity a ring asked for requested bytes gets: the next power of two, at least 8 and at most MAX_CAPACITY
+    static constexpr bb_size_t capacityFor(bb_size_t requested) {
+        if (requested < 8)
+            return 8;
+        if (requested > MAX_CAPACITY) // bit_ceil() of this isn't representable
+            return MAX_CAPACITY;
+        return std::bit_ceil(requested);
+    }
+
+    bb_size_t capacity() const {
+        return mask + 1;
+    }
+    bb_size_t bytesRemaining() const { // Bytes available to read
+        return static_cast<bb_size_t>(tail - head);
+    }
+    bb_size_t bytesFree() const { // Bytes that can be written before the buffer is full
+        return capacity() - bytesRemaining();
+    }
+    bool empty() const {
+        return head == tail;
+    }
+    void clear() {
+        head = tail = 0;
+        failed = false;
+    }
+
+    // Sticky error state, see ByteBuffer::ok(). Set by a typed get with too few bytes or a typed put that didn't fit
+    bool ok() const {
+        return !failed;
+    }
+    void clearError() {
+        failed = false;
+    }
+
+    // Zero-copy access. Each returns up to two spans because the region may wrap around the end of the storage
+    std::array<std::span<const uint8_t>, 2> data() const; // The readable bytes, in order
+    void consume(bb_size_t n); // Drop n bytes from the front after reading them through data()
+    std::array<std::span<uint8_t>, 2> prepare(); // The free space, in order. ie. for readv()
+    void commit(bb_size_t n); // Make n bytes written into prepare()'s spans readable
+
+    // Bulk transfers. Return the number of bytes actually moved
+    bb_size_t write(const uint8_t* src, bb_size_t len);
+    bb_size_t read(uint8_t* dst, bb_size_t len);
+    bb_size_t peek(uint8_t* dst, bb_size_t len, bb_size_t offset = 0) const; // Copy without consuming, starting offset bytes in
+
+    // Read
+
+    uint8_t get();
+    char getChar();
+    double getDouble();
+    float getFloat();
+    uint32_t getInt();
+    uint64_t getLong();
+    uint16_t getShort();
+
+    template<std::endian E> double getDouble() { return endianConvert<E>(getValue<double>()); }
+    template<std::endian E> float getFloat() { return endianConvert<E>(getValue<float>()); }
+    template<std::endian E> uint32_t getInt() { return endianConvert<E>(getValue<uint32_t>()); }
+    template<std::endian E> uint64_t getLong() { return endianConvert<E>(getValue<uint64_t>()); }
+    template<std::endian E> uint16_t getShort() { return endianConvert<E>(getValue<uint16_t>()); }
+
+    // Write
+
+    void put(uint8_t b);
+    void putChar(char value);
+    void putDouble(double value);
+    void putFloat(float value);
+    void putInt(uint32_t value);
+    void putLong(uint64_t value);
+    void putShort(uint16_t value);
+
+    template<std::endian E> void putDouble(double value) { putValue<double>(endianConvert<E>(value)); }
+    template<std::endian E> void putFloat(float value) { putValue<float>(endianConvert<E>(value)); }
+    template<std::endian E> void putInt(uint32_t value) { putValue<uint32_t>(endianConvert<E>(value)); }
+    template<std::endian E> void putLong(uint64_t value) { putValue<uint64_t>(endianConvert<E>(value)); }
+    template<std::endian E> void putShort(uint16_t value) { putValue<uint16_t>(endianConvert<E>(value)); }
+
+private:
+    std::unique_ptr<uint8_t[]> buf;
+    bb_size_t mask = 0;
+    // Free running counters. Only their difference and their low bits (& mask) are used, so they can wrap
+    bb_size_t head = 0; // Next byte to read
+    bb_size_t tail = 0; // Next byte to write
+    bool failed = false;
+
+    void copyOut(bb_size_t from, uint8_t* dst, bb_size_t len) const;
+    void copyIn(bb_size_t to, const uint8_t* src, bb_size_t len);
+
+    template<typename T> T getValue() {
+        if (bytesRemaining() < sizeof(T)) {
+            failed = true;
+            return T{};
+        }
+
+        T data;
+        copyOut(head, reinterpret_cast<uint8_t*>(&data), sizeof(T));
+        head += sizeof(T);
+        return data;
+    }
+
+    template<typename T> void putValue(T data) {
+        if (bytesFree() < sizeof(T)) {
+            failed = true;
+            return;
+        }
+
+        copyIn(tail, reinterpret_cast<const uint8_t*>(&data), sizeof(T));
+        tail += sizeof(T);
+    }
+};
+
+#ifdef BB_USE_NS
+}
+#endif
+
+#endif
@@ -0,0 +1,202 @@
+/**
+ ByteBuffer
+ StreamByteReader.cpp
+ Copyright 2011-2025 Ramsey Kant
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "StreamByteReader.hpp"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+#ifdef BB_USE_NS
+namespace bb {
+#endif
+
+/**
+ * StreamByteReader constructor
+ *
+ * @param src Callable the stream is read from
+ * @param windowSize Size of the window in bytes. Raised to 8 if smaller, so any single value fits
+ */
+StreamByteReader::StreamByteReader(Source src, bb_size_t windowSize)
+    : source(std::move(src)), cap(windowSize < sizeof(uint64_t) ? sizeof(uint64_t) : windowSize) {
+    window = std::make_unique_for_overwrite<uint8_t[]>(cap);
+}
+
+#ifndef _WIN32
+/**
+ * StreamByteReader constructor
+ * Read the stream from a file descriptor (file, pipe, socket). Interrupted reads are retried; any other error ends
+ * the stream
+ *
+ * @param fd Open file descriptor. The caller keeps ownership
+ * @param windowSize Size of the window in bytes
+ */
+StreamByteReader::StreamByteReader(int fd, bb_size_t windowSize)
+    : StreamByteReader([fd](void* buf, size_t len) -> size_t {
+          ssize_t n;
+          do {
+              n = ::read(fd, buf, len);
+          } while (n < 0 && errno == EINTR);
+          return n < 0 ? 0 : static_cast<size_t>(n);
+      }, windowSize) {
+}
+#endif
+
+/**
+ * EOF
+ * Whether the whole stream has been read. May read from the source to find out
+ *
+ * @return True if no more bytes can be read
+ */
+bool StreamByteReader::eof() {
+    return rpos == end && !ensure(1);
+}
+
+/**
+ * Ensure
+ * Make at least n unread bytes available in the window. The unread bytes are moved to the front of the window,
+ * then the source is read until there are enough of them or it runs dry
+ *
+ * @param n Number of bytes needed. Can't be more than windowSize()
+ * @return True if n bytes are available, false if the stream ended first or n is larger than the window
+ */
+bool StreamByteReader::ensure(bb_size_t n) {
+    if (end - rpos >= n)
+        return true;
+    if (n > cap || exhausted)
+        return false;
+
+    // Compact
+    const bb_size_t unread = end - rpos;
+    if (rpos > 0) {
+        std::memmove(window.get(), window.get() + rpos, unread);
+        rpos = 0;
+        end = unread;
+    }
+
+    while (end < n) {
+        size_t got = source(window.get() + end, cap - end);
+        if (got == 0) {
+            exhausted = true;
+            return false;
+        }
+        end += got;
+    }
+    return true;
+}
+
+/**
+ * Skip
+ * Discard the next n bytes of the stream. Clears ok() if the stream ends first
+ *
+ * @param n Number of bytes to skip
+ */
+void StreamByteReader::skip(uint64_t n) {
+    while (n > 0) {
+        if (rpos == end && !ensure(1)) {
+            failed = true;
+            return;
+        }
+        const bb_size_t step = n < end - rpos ? static_cast<bb_size_t>(n) : end - rpos;
+        rpos += step;
+        consumed += step;
+        n -= step;
+    }
+}
+
+// Read Functions
+
+uint8_t StreamByteReader::peek() {
+    if (!ensure(1))
+        return 0;
+    return window[rpos];
+}
+
+uint8_t StreamByteReader::get() {
+    return read<uint8_t>();
+}
+
+/**
+ * Get Bytes
+ * Relative read of out_len bytes into out_buf. Whatever is in the window is copied first; the rest goes straight
+ * from the source into out_buf, so a large read doesn't pass through the window.
+ * If the stream ends first, the rest of out_buf is zero-filled and ok() is cleared
+ *
+ * @param out_buf Destination, at least out_len bytes long
+ * @param out_len Number of bytes to read
+ */
+void StreamByteReader::getBytes(uint8_t* const out_buf, bb_size_t out_len) {
+    bb_size_t done = end - rpos < out_len ? end - rpos : out_len;
+    std::memcpy(out_buf, window.get() + rpos, done);
+    rpos += done;
+
+    if (done < out_len && out_len - done >= cap) {
+        // Big read: bypass the window
+        while (done < out_len && !exhausted) {
+            size_t got = source(out_buf + done, out_len - done);
+            if (got == 0)
+                exhausted = true;
+            done += got;
+        }
+    } else if (done < out_len && ensure(out_len - done)) {
+        std::memcpy(out_buf + done, window.get() + rpos, out_len - done);
+        rpos += out_len - done;
+        done = out_len;
+    } else if (done < out_len) {
+        // Stream ends before out_len: hand over whatever is left
+        const bb_size_t rest = end - rpos;
+        std::memcpy(out_buf + done, window.get() + rpos, rest);
+        rpos = end;
+        done += rest;
+    }
+
+    consumed += done;
+    if (done < out_len) {
+        std::memset(out_buf + done, 0, out_len - done);
+        failed = true;
+    }
+}
+
+char StreamByteReader::getChar() {
+    return read<char>();
+}
+
+double StreamByteReader::getDouble() {
+    return read<double>();
+}
+
+float StreamByteReader::getFloat() {
+    return read<float>();
+}
+
+uint32_t StreamByteReader::getInt() {
+    return read<uint32_t>();
+}
+
+uint64_t StreamByteReader::getLong() {
+    return read<uint64_t>();
+}
+
+uint16_t StreamByteReader::getShort() {
+    return read<uint16_t>();
+}
+
+#ifdef BB_USE_NS
+}
+#endif
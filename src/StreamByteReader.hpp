@@ -0,0 +1,118 @@
+/**
+ ByteBuffer
+ StreamByteReader.hpp
+ Copyright 2011-2025 Ramsey Kant
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef _STREAMBYTEREADER_H_
+#define _STREAMBYTEREADER_H_
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+
+#include "ByteBuffer.hpp"
+
+#ifdef BB_USE_NS
+namespace bb {
+#endif
+
+// Reads a stream of any length through a fixed-size window, with the ByteBuffer get API. When a read needs more
+// bytes than are left in the window, the unread bytes are moved to the front and the window is refilled from the
+// source. Reading past the end of the stream returns zeroes and clears ok()
+class StreamByteReader {
+public:
+    // Reads up to len bytes into buf. Returns the number of bytes read, 0 at the end of the stream or on error
+    using Source = std::function<size_t(void* buf, size_t len)>;
+
+    explicit StreamByteReader(Source src, bb_size_t windowSize = BB_DEFAULT_SIZE);
+#ifndef _WIN32
+    explicit StreamByteReader(int fd, bb_size_t windowSize = BB_DEFAULT_SIZE); // Read from a file descriptor with read(). The fd is not closed
+#endif
+
+    bool ok() const { // False once a read has run past the end of the stream
+        return !failed;
+    }
+    void clearError() {
+        failed = false;
+    }
+    bool eof(); // True if the source is exhausted and every byte has been read
+    uint64_t position() const { // Number of bytes consumed from the stream so far
+        return consumed;
+    }
+    bb_size_t buffered() const { // Bytes in the window that haven't been read yet
+        return end - rpos;
+    }
+    bb_size_t windowSize() const {
+        return cap;
+    }
+
+    bool ensure(bb_size_t n); // Refill until at least n (<= windowSize()) unread bytes are in the window
+    void skip(uint64_t n); // Discard the next n bytes
+
+    // Read
+
+    uint8_t peek(); // Next byte without consuming it
+    uint8_t get();
+    void getBytes(uint8_t* const out_buf, bb_size_t out_len); // Reads larger than the window are streamed straight into out_buf
+    char getChar();
+    double getDouble();
+    float getFloat();
+    uint32_t getInt();
+    uint64_t getLong();
+    uint16_t getShort();
+
+    // Read with an explicit byte order, ie. getInt<BB_NETWORK_ORDER>()
+
+    template<std::endian E> double getDouble() { return endianConvert<E>(read<double>()); }
+    template<std::endian E> float getFloat() { return endianConvert<E>(read<float>()); }
+    template<std::endian E> uint32_t getInt() { return endianConvert<E>(read<uint32_t>()); }
+    template<std::endian E> uint64_t getLong() { return endianConvert<E>(read<uint64_t>()); }
+    template<std::endian E> uint16_t getShort() { return endianConvert<E>(read<uint16_t>()); }
+
+private:
+    Source source;
+    std::unique_ptr<uint8_t[]> window;
+    bb_size_t cap = 0;
+    bb_size_t rpos = 0; // Next unread byte in window
+    bb_size_t end = 0; // End of the valid bytes in window
+    uint64_t consumed = 0;
+    bool exhausted = false; // Source has returned 0
+    bool failed = false;
+
+    template<typename T> T read() {
+        if (end - rpos < sizeof(T) && !ensure(sizeof(T))) [[unlikely]] {
+            failed = true;
+            consumed += end - rpos; // The partial value left at the end of the stream is dropped
+            rpos = end;
+            return T{};
+        }
+
+        T data;
+        std::memcpy(&data, window.get() + rpos, sizeof(T));
+        rpos += sizeof(T);
+        consumed += sizeof(T);
+        return data;
+    }
+};
+
+#ifdef BB_USE_NS
+}
+#endif
+
+#endif
@@ -0,0 +1,206 @@
+/**
+ ByteBuffer
+ HTTPChunked.cpp
+ Copyright 2011-2025 Ramsey Kant
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "HTTPChunked.h"
+
+#include <charconv>
+#include <cstring>
+
+/**
+ * Decode
+ * Decode as much of the chunked body as has arrived
+ *
+ * @param buf Encoded body received so far, starting at the first chunk-size line. Modified in place
+ * @param trailers Message to add trailer fields to, or nullptr to drop them
+ * @return Complete once the last chunk and trailers have been read, NeedMore if more bytes are needed, Error if the
+ *         encoding is invalid (see getError())
+ */
+HTTPChunkedDecoder::Result HTTPChunkedDecoder::decode(std::span<uint8_t> buf, HTTPMessage* trailers) {
+    std::string_view line;
+    while (true) {
+        switch (state) {
+        case State::Size:
+            if (!nextLine(buf, line))
+                return state == State::Failed ? Result::Error : Result::NeedMore;
+            if (!parseSize(line))
+                return Result::Error;
+            break;
+
+        case State::Data: {
+            const size_t avail = buf.size() - readPos;
+            const size_t n = chunkLeft < avail ? static_cast<size_t>(chunkLeft) : avail;
+            if (n > 0 && writePos != readPos)
+                std::memmove(buf.data() + writePos, buf.data() + readPos, n);
+            writePos += n;
+            readPos += n;
+            scanPos = readPos;
+            chunkLeft -= n;
+            if (chunkLeft > 0)
+                return Result::NeedMore;
+            state = State::DataEnd;
+            break;
+        }
+
+        case State::DataEnd:
+            // Every chunk's payload is followed by CRLF (or a bare LF)
+            if (!nextLine(buf, line))
+                return state == State::Failed ? Result::Error : Result::NeedMore;
+            if (!line.empty())
+                return fail("Chunk data longer than its size");
+            state = State::Size;
+            break;
+
+        case State::Trailer:
+            if (!nextLine(buf, line))
+                return state == State::Failed ? Result::Error : Result::NeedMore;
+            if (line.empty()) {
+                state = State::Done;
+                break;
+            }
+            if (trailers != nullptr)
+                trailers->addHeader(line);
+            break;
+
+        case State::Done:
+            return Result::Complete;
+
+        case State::Failed:
+            return Result::Error;
+        }
+    }
+}
+
+// Find the next complete line (without CR or LF) and consume it. The search never rescans bytes already searched
+bool HTTPChunkedDecoder::nextLine(std::span<uint8_t> buf, std::string_view& line) {
+    const void* lf = scanPos < buf.size() ? std::memchr(buf.data() + scanPos, '\n', buf.size() - scanPos) : nullptr;
+    if (lf == nullptr) {
+        scanPos = buf.size();
+        if (scanPos - readPos > MAX_LINE_SIZE)
+            fail("Chunk line exceeds maximum size");
+        return false;
+    }
+
+    const size_t lfPos = static_cast<const uint8_t*>(lf) - buf.data();
+    size_t end = lfPos;
+    if (end > readPos && buf[end - 1] == '\r')
+        end--;
+
+    line = std::string_view(reinterpret_cast<const char*>(buf.data()) + readPos, end - readPos);
+    readPos = scanPos = lfPos + 1;
+    return true;
+}
+
+// chunk-size [ ; chunk-ext ]. Extensions are ignored
+bool HTTPChunkedDecoder::parseSize(std::string_view line) {
+    uint64_t size = 0;
+    auto [ptr, ec] = std::from_chars(line.data(), line.data() + line.size(), size, 16);
+    if (ec != std::errc{} || (ptr != line.data() + line.size() && *ptr != ';' && *ptr != ' ' && *ptr != '\t')) {
+        fail("Invalid chunk size");
+        return false;
+    }
+    if (size > MAX_CONTENT_LENGTH || writePos + size > MAX_CONTENT_LENGTH) {
+        fail("Chunked body exceeds maximum allowed size");
+        return false;
+    }
+
+    chunkLeft = size;
+    state = size == 0 ? State::Trailer : State::Data;
+    return true;
+}
+
+HTTPChunkedDecoder::Result HTTPChunkedDecoder::fail(std::string_view reason) {
+    error = reason;
+    state = State::Failed;
+    return Result::Error;
+}
+
+// Chunk-size line for len bytes: hex length and CRLF
+static size_t chunkHeader(char (&out)[24], size_t len) {
+    auto [end, ec] = std::to_chars(out, out + sizeof(out) - 2, len, 16);
+    end[0] = '\r';
+    end[1] = '\n';
+    return end + 2 - out;
+}
+
+/**
+ * Put Chunk
+ * Append one chunk (size line, body, CRLF) to out
+ *
+ * @param out Buffer to append to, ie. an HTTPResponse after its headers were written
+ * @param body Piece of the body. Nothing is written if it is empty
+ */
+void putChunk(ByteBuffer& out, std::span<const uint8_t> body) {
+    if (body.empty())
+        return;
+
+    char hdr[24];
+    out.putBytes(reinterpret_cast<const uint8_t*>(hdr), chunkHeader(hdr, body.size()));
+    out.putBytes(body.data(), body.size());
+    out.putBytes(reinterpret_cast<const uint8_t*>("\r\n"), 2);
+}
+
+/**
+ * Put Last Chunk
+ * Append the zero-length chunk that ends the body, followed by any trailer fields and the final blank line
+ *
+ * @param out Buffer to append to
+ * @param trailers Trailer fields as (name, value) pairs
+ */
+void putLastChunk(ByteBuffer& out, std::span<const std::pair<std::string_view, std::string_view>> trailers) {
+    out.putBytes(reinterpret_cast<const uint8_t*>("0\r\n"), 3);
+    for (auto const &[key, value] : trailers) {
+        out.putBytes(reinterpret_cast<const uint8_t*>(key.data()), key.size());
+        out.putBytes(reinterpret_cast<const uint8_t*>(": "), 2);
+        out.putBytes(reinterpret_cast<const uint8_t*>(value.data()), value.size());
+        out.putBytes(reinterpret_cast<const uint8_t*>("\r\n"), 2);
+    }
+    out.putBytes(reinterpret_cast<const uint8_t*>("\r\n"), 2);
+}
+
+#ifndef _WIN32
+static constexpr uint8_t CRLF[] = {'\r', '\n'};
+static constexpr uint8_t LAST_CHUNK[] = {'0', '\r', '\n', '\r', '\n'};
+
+/**
+ * Append Chunk
+ * Append one chunk to a chain for writev(). Only the few bytes of the size line are copied (into the chain's shared
+ * copy blocks, not an allocation per chunk); body is referenced
+ *
+ * @param out Chain to append to
+ * @param body Piece of the body. Borrowed: must stay valid until the chain has sent it. Skipped if empty
+ */
+void appendChunk(ByteBufferChain& out, std::span<const uint8_t> body) {
+    if (body.empty())
+        return;
+
+    char hdr[24];
+    out.appendCopy(std::span(reinterpret_cast<const uint8_t*>(hdr), chunkHeader(hdr, body.size())));
+    out.append(body);
+    out.append(CRLF);
+}
+
+/**
+ * Append Last Chunk
+ * Append the zero-length chunk and blank line that end the body
+ *
+ * @param out Chain to append to
+ */
+void appendLastChunk(ByteBufferChain& out) {
+    out.append(LAST_CHUNK);
+}
+#endif
@@ -0,0 +1,91 @@
+/**
+ ByteBuffer
+ HTTPChunked.h
+ Copyright 2011-2025 Ramsey Kant
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef _HTTPCHUNKED_H_
+#define _HTTPCHUNKED_H_
+
+#include "HTTPMessage.h"
+
+#ifndef _WIN32
+#include "../../ByteBufferChain.hpp"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <utility>
+
+// Streaming decoder for a chunked transfer-encoded body (RFC 9112 section 7.1). The chunk payloads are moved down
+// over the chunk framing in place, so once decoding is complete the body is contiguous at the start of the encoded
+// bytes and nothing was copied to a temporary. Decoding resumes where the previous call stopped
+class HTTPChunkedDecoder {
+public:
+    enum class Result {
+        NeedMore,
+        Complete,
+        Error
+    };
+
+    // buf holds the encoded body received so far, starting at the first chunk-size line. It may have grown (and moved)
+    // since the last call, but the bytes already passed to decode() must not have changed. Trailer fields are added to
+    // trailers as headers, if given
+    Result decode(std::span<uint8_t> buf, HTTPMessage* trailers = nullptr);
+
+    size_t decodedSize() const { // Body bytes at the start of buf so far
+        return writePos;
+    }
+    size_t encodedSize() const { // Bytes of buf consumed so far, the whole encoded body once complete
+        return readPos;
+    }
+    std::string_view getError() const {
+        return error;
+    }
+
+private:
+    enum class State {
+        Size,
+        Data,
+        DataEnd,
+        Trailer,
+        Done,
+        Failed
+    };
+
+    State state = State::Size;
+    size_t readPos = 0; // Next encoded byte
+    size_t writePos = 0; // End of the decoded body. Never past readPos
+    size_t scanPos = 0; // Where the search for the next LF resumes
+    uint64_t chunkLeft = 0; // Payload bytes left in the current chunk
+    std::string_view error;
+
+    bool nextLine(std::span<uint8_t> buf, std::string_view& line);
+    bool parseSize(std::string_view line);
+    Result fail(std::string_view reason);
+};
+
+// Chunked encoding. Each call frames one piece of the body, so a body can be sent as it is produced without knowing
+// its length up front. A zero-length chunk would end the body early, so empty pieces are skipped
+void putChunk(ByteBuffer& out, std::span<const uint8_t> body); // Copies body behind its chunk header
+void putLastChunk(ByteBuffer& out, std::span<const std::pair<std::string_view, std::string_view>> trailers = {});
+#ifndef _WIN32
+void appendChunk(ByteBufferChain& out, std::span<const uint8_t> body); // Borrows body: it must outlive the send
+void appendLastChunk(ByteBufferChain& out);
+#endif
+
+#endif
@@ -17,26 +17,53 @@
 */
 
 #include "HTTPMessage.h"
+#include "HTTPChunked.h"
 
 #include <algorithm>
 #include <string>
 #include <format>
 #include <memory>
 #include <print>
-#include <ranges>
 
-#include <cctype>  // to std::tolower
 #include <charconv>
 
+// ASCII lowercase. Header names are ASCII, and unlike std::tolower this doesn't depend on the locale
+static constexpr char lowerAscii(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+// FNV-1a over the lowercased key, so differently cased names hash the same
+static uint32_t headerHash(std::string_view key) {
+    uint32_t h = 2166136261u;
+    for (char c : key) {
+        h ^= static_cast<uint8_t>(lowerAscii(c));
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (lowerAscii(a[i]) != lowerAscii(b[i]))
+            return false;
+    }
+    return true;
+}
+
 
 HTTPMessage::HTTPMessage() : ByteBuffer(4096) {
 }
 
-HTTPMessage::HTTPMessage(std::string const& sData) : ByteBuffer(sData.size() + 1) {
+HTTPMessage::HTTPMessage(std::pmr::memory_resource* mr) : ByteBuffer(4096, mr) {
+}
+
+HTTPMessage::HTTPMessage(std::string const& sData, std::pmr::memory_resource* mr) : ByteBuffer(sData.size() + 1, mr) {
     putBytes((const uint8_t* const)sData.c_str(), sData.size() + 1);
 }
 
-HTTPMessage::HTTPMessage(const uint8_t* pData, uint32_t len) : ByteBuffer(pData, len) {
+HTTPMessage::HTTPMessage(const uint8_t* pData, uint32_t len, std::pmr::memory_resource* mr) : ByteBuffer(pData, len, mr) {
 }
 
 /**
@@ -54,12 +81,17 @@ void HTTPMessage::putLine(std::string_view str, bool crlf_end) {
 
 /**
  * Put Headers
- * Write all headers currently in the 'headers' map to the ByteBuffer.
+ * Write all headers currently in the header table to the ByteBuffer, in the order they were added.
  * 'Header: value'
  */
 void HTTPMessage::putHeaders() {
-    for (auto const &[key, value] : headers) {
-        putLine(std::format("{}: {}", key, value), true);
+    // Writing may move the message bytes, so headers referencing them are copied out first
+    ownHeaders();
+
+    for (const HeaderField& h : headers) {
+        putLine(headerKey(h), false);
+        putLine(": ", false);
+        putLine(headerValue(h));
     }
 
     // End with a blank line
@@ -74,45 +106,34 @@ void HTTPMessage::putHeaders() {
  * @return Contents of the line in a string (without CR or LF)
  */
 std::string HTTPMessage::getLine() {
+    return std::string(getLineView());
+}
+
+/**
+ * Get Line View
+ * Like getLine(), but the line is returned as a view of the message bytes instead of a copy. The line end is found
+ * with a vectorized CR/LF scan (ByteBuffer::findEol)
+ *
+ * @return Contents of the line (without CR or LF). Empty if no complete line is available, in which case the read
+ *         position is unchanged. Invalidated by any change to the message bytes
+ */
+std::string_view HTTPMessage::getLineView() {
     const uint32_t startPos = getReadPos();
     const uint32_t bufSize = size();
 
-    if (startPos >= bufSize)
-        return "";
-
-    // Scan for the first CR or LF without advancing rpos
-    int32_t crlfPos = -1;
-    for (uint32_t i = startPos; i < bufSize; i++) {
-        const char c = getChar(i); // absolute read at index — rpos unchanged
-        if (c == '\r' || c == '\n') {
-            crlfPos = static_cast<int32_t>(i);
-            break;
-        }
-    }
-
     // No line terminator found — no complete line available
-    if (crlfPos < 0) {
-        // Reset the position to before the last line read that we are now discarding
-        setReadPos(startPos);
+    const int64_t crlfPos = findEol(startPos);
+    if (crlfPos < 0)
         return "";
-    }
 
-    // Copy line content into our HTTPMessage ByteBuffer
-    uint32_t lineLen = static_cast<uint32_t>(crlfPos) - startPos;
-    std::string ret(lineLen, '\0');
-    if (lineLen > 0)
-        getBytes(reinterpret_cast<uint8_t*>(ret.data()), lineLen);
-    // rpos is now at crlfPos
-
-    // Consume up to 2 CR/LF bytes (\r\n as a pair) without skipping a following blank line
-    uint32_t k = 0;
-    while (getReadPos() < bufSize && k < 2) {
-        const auto c = static_cast<char>(peek());
-        if (c != '\r' && c != '\n')
-            break;
-        get();
-        k++;
-    }
+    const char* const bytes = reinterpret_cast<const char*>(ByteBuffer::data());
+    std::string_view ret(bytes + startPos, static_cast<uint32_t>(crlfPos) - startPos);
+
+    // Consume the line ending: \r\n as a pair, or a lone \r or \n, so a following blank line isn't skipped
+    uint32_t next = static_cast<uint32_t>(crlfPos) + 1;
+    if (bytes[crlfPos] == '\r' && next < bufSize && bytes[next] == '\n')
+        next++;
+    setReadPos(next);
 
     return ret;
 }
@@ -125,27 +146,20 @@ std::string HTTPMessage::getLine() {
  * @return Token found in the buffer. Empty if delimiter wasn't reached
  */
 std::string HTTPMessage::getStrElement(char delim) {
-    int32_t startPos = getReadPos();
-    if (startPos < 0)
-        return "";
+    const uint32_t startPos = getReadPos();
 
-    int32_t endPos = find(delim, startPos);
+    const int64_t endPos = find(delim, startPos);
     if (endPos < 0)
         return "";
 
-    if (startPos > endPos)
-        return "";
-
     // Token spans [startPos, endPos); delimiter sits at endPos
     auto tokenLen = static_cast<uint32_t>(endPos - startPos);
     if (tokenLen == 0)
         return "";
 
     // Grab the token bytes (excludes delimiter), then step past the delimiter
-    auto str = std::make_unique<char[]>(tokenLen + 1);
-    getBytes(reinterpret_cast<uint8_t*>(str.get()), tokenLen);
-    str[tokenLen] = '\0';
-    std::string ret(str.get(), tokenLen);
+    std::string ret(tokenLen, '\0');
+    getBytes(reinterpret_cast<uint8_t*>(ret.data()), tokenLen);
 
     // Advance the read position past the delimiter
     setReadPos(static_cast<uint32_t>(endPos) + 1);
@@ -160,33 +174,36 @@ std::string HTTPMessage::getStrElement(char delim) {
  * Parse headers will move the read position past the blank line that signals the end of the headers
  */
 bool HTTPMessage::parseHeaders() {
-    constexpr uint32_t MAX_HEADERS = 128;
-    constexpr uint32_t MAX_MULTILINE_SIZE = 16384; // 16 KB cap on accumulated multiline header value
-
     uint32_t header_count = 0;
-    std::string hline = getLine();
+    std::string_view hline = getLineView();
 
-    // Keep pulling headers until a blank line has been reached (signaling the end of headers)
+    // Keep pulling headers until a blank line has been reached (signaling the end of headers).
+    // Lines are views of the message bytes, so a single-line header is added without copying it
     while (!hline.empty()) {
         if (++header_count > MAX_HEADERS) {
             parseErrorStr = "Too many headers";
             return false;
         }
 
-        // Case where values are on multiple lines ending with a comma
-        uint32_t accumulated = hline.size();
-        while (!hline.empty() && hline.back() == ',') {
-            std::string app = getLine();
-            accumulated += app.size();
-            if (accumulated > MAX_MULTILINE_SIZE) {
-                parseErrorStr = "Multiline header value exceeds maximum size";
-                return false;
+        // Case where values are on multiple lines ending with a comma. Only these have to be joined into a copy
+        if (hline.back() == ',') {
+            std::string joined(hline);
+            while (!joined.empty() && joined.back() == ',') {
+                std::string_view app = getLineView();
+                if (joined.size() + app.size() > MAX_MULTILINE_SIZE) {
+                    parseErrorStr = "Multiline header value exceeds maximum size";
+                    return false;
+                }
+                joined += app;
+                if (app.empty())
+                    break;
             }
-            hline += app;
+            addHeader(joined);
+        } else {
+            addHeader(hline);
         }
 
-        addHeader(hline);
-        hline = getLine();
+        hline = getLineView();
     }
 
     return true;
@@ -199,6 +216,9 @@ bool HTTPMessage::parseHeaders() {
  * @return True if successful. False on error, parseErrorStr is set with a reason
  */
 bool HTTPMessage::parseBody() {
+    if (isChunked())
+        return parseChunkedBody();
+
     // Content-Length should exist (size of the Body data) if there is body data
     std::string hlenstr = "";
     hlenstr = getHeaderValue("Content-Length");
@@ -209,33 +229,16 @@ bool HTTPMessage::parseBody() {
 
     uint32_t remainingLen = bytesRemaining();
     uint32_t contentLen = 0;
-
-    // Validate Content-Length is an integer
-    auto [ptr, ec] = std::from_chars(hlenstr.data(), hlenstr.data() + hlenstr.size(), contentLen);
-    if (ec != std::errc{}) {
-        parseErrorStr = std::format("Invalid Content-Length value: {}", hlenstr);
-        this->dataLen = 0;
+    if (!parseContentLength(contentLen))
         return false;
-    }
-
-    constexpr uint32_t MAX_CONTENT_LENGTH = 256u * 1024u * 1024u; // 256 MB
-    if (contentLen > MAX_CONTENT_LENGTH) {
-        parseErrorStr = std::format("Content-Length {} exceeds maximum allowed size", contentLen);
-        this->dataLen = 0;
-        return false;
-    }
 
     // contentLen should NOT exceed the remaining number of bytes in the buffer
-    // Add 1 to bytesRemaining so it includes the byte at the current read position
-    if (static_cast<uint64_t>(contentLen) > static_cast<uint64_t>(remainingLen) + 1) {
+    // Bytes beyond contentLen are not an error: they belong to the next (pipelined) message and are left unread
+    if (contentLen > remainingLen) {
         // If it exceeds, there's a potential security issue and we can't reliably parse
         parseErrorStr = std::format("Content-Length ({}) is greater than remaining bytes ({})", hlenstr, remainingLen);
         this->dataLen = 0;
         return false;
-    } else if (remainingLen > contentLen) {
-        parseErrorStr = std::format("ByteBuffer remaining size to read ({}) is greater than provided Content-Length {}", remainingLen, contentLen);
-        this->dataLen = 0;
-        return false;
     } else if (contentLen == 0) {
         // Nothing to read, which is fine
         return true;
@@ -247,9 +250,98 @@ bool HTTPMessage::parseBody() {
     // Create a big enough buffer to store the data and read from the current position
     this->data = std::make_unique<uint8_t[]>(this->dataLen);
     getBytes(this->data.get(), this->dataLen);
+    if (!ok()) {
+        parseErrorStr = std::format("Body is shorter than Content-Length ({})", contentLen);
+        this->data.reset();
+        this->dataLen = 0;
+        return false;
+    }
 
-    // We could handle chunked Request/Response parsing (with footers) here, but, we won't.
+    return true;
+}
 
+/**
+ * Parse Chunked Body
+ * Decodes a chunked transfer-encoded body starting at the current read position. The chunks are joined in place over
+ * the message's bytes before being copied out, and trailer fields are added to the headers
+ *
+ * @return True if successful. False if the body is invalid or incomplete, parseErrorStr is set with a reason
+ */
+bool HTTPMessage::parseChunkedBody() {
+    const uint32_t start = getReadPos();
+    HTTPChunkedDecoder decoder;
+    auto res = decoder.decode(std::span<uint8_t>(writableData() + start, size() - start), this);
+    if (res == HTTPChunkedDecoder::Result::Error) {
+        parseErrorStr = decoder.getError();
+        return false;
+    } else if (res == HTTPChunkedDecoder::Result::NeedMore) {
+        parseErrorStr = "Incomplete chunked body";
+        return false;
+    }
+
+    setChunkedBody(start, decoder);
+    return true;
+}
+
+/**
+ * Set Chunked Body
+ * Copy out a body that HTTPChunkedDecoder finished decoding in place and move the read position past its encoding
+ *
+ * @param start Position of the first chunk-size line
+ * @param decoder Decoder that returned Complete
+ */
+void HTTPMessage::setChunkedBody(uint32_t start, HTTPChunkedDecoder const& decoder) {
+    this->dataLen = static_cast<uint32_t>(decoder.decodedSize());
+    if (this->dataLen > 0) {
+        this->data = std::make_unique<uint8_t[]>(this->dataLen);
+        std::memcpy(this->data.get(), ByteBuffer::data() + start, this->dataLen);
+    }
+    setReadPos(start + static_cast<uint32_t>(decoder.encodedSize()));
+}
+
+/**
+ * Is Chunked
+ * Whether the body uses chunked transfer-encoding, ie. chunked is the last coding in Transfer-Encoding
+ *
+ * @return True if the body must be decoded with HTTPChunkedDecoder
+ */
+bool HTTPMessage::isChunked() const {
+    std::string_view te = getHeaderView("Transfer-Encoding");
+    if (size_t comma = te.rfind(','); comma != std::string_view::npos)
+        te.remove_prefix(comma + 1);
+    while (!te.empty() && (te.front() == ' ' || te.front() == '\t'))
+        te.remove_prefix(1);
+    while (!te.empty() && (te.back() == ' ' || te.back() == '\t'))
+        te.remove_suffix(1);
+    return equalsIgnoreCase(te, "chunked");
+}
+
+/**
+ * Parse Content-Length
+ * Read and validate the Content-Length header
+ *
+ * @param contentLen Set to the body length, or 0 if there is no Content-Length header
+ * @return True if successful. False if the value isn't a number or is too large, parseErrorStr is set with a reason
+ */
+bool HTTPMessage::parseContentLength(uint32_t& contentLen) {
+    contentLen = 0;
+    std::string hlenstr = getHeaderValue("Content-Length");
+    if (hlenstr.empty())
+        return true;
+
+    // Validate Content-Length is an integer
+    auto [ptr, ec] = std::from_chars(hlenstr.data(), hlenstr.data() + hlenstr.size(), contentLen);
+    if (ec != std::errc{}) {
+        parseErrorStr = std::format("Invalid Content-Length value: {}", hlenstr);
+        this->dataLen = 0;
+        return false;
+    }
+
+    if (contentLen > MAX_CONTENT_LENGTH) {
+        parseErrorStr = std::format("Content-Length {} exceeds maximum allowed size", contentLen);
+        this->dataLen = 0;
+        return false;
+    }
     return true;
 }
 
@@ -297,74 +389,104 @@ void HTTPMessage::addHeader(std::string_view line) {
 }
 
 /**
- * Add header key-value std::pair to the map
+ * Add header key-value pair to the header table
+ * Key and value are referenced in place if they point into the message's bytes, copied otherwise
  *
  * @param key String representation of the Header Key
  * @param value String representation of the Header value
  */
 void HTTPMessage::addHeader(std::string_view key, std::string_view value) {
-    auto key_lower = key
-                     | std::views::transform([](unsigned char c){ return std::tolower(c); })
-                     | std::ranges::to<std::string>();
-    headers.try_emplace(std::move(key_lower), std::string(value));
+    const uint32_t hash = headerHash(key);
+    if (findHeader(key, hash) != nullptr)
+        return;
+
+    const char* const bytes = reinterpret_cast<const char*>(ByteBuffer::data());
+    auto inMessage = [&](std::string_view v) {
+        return bytes != nullptr && v.data() >= bytes && v.data() + v.size() <= bytes + size();
+    };
+
+    if (inMessage(key) && inMessage(value)) {
+        headers.push_back({static_cast<uint32_t>(key.data() - bytes), static_cast<uint32_t>(key.size()),
+                           static_cast<uint32_t>(value.data() - bytes), static_cast<uint32_t>(value.size()), hash, false});
+        return;
+    }
+
+    // key or value may be a view into ownedBytes (ie. from getHeaderView()), which growing it would free. Reserve the
+    // room up front and re-point such views at the reserved storage, so neither append reallocates
+    const char* const owned = ownedBytes.data();
+    auto ownedOffset = [&](std::string_view v) {
+        return v.data() >= owned && v.data() + v.size() <= owned + ownedBytes.size() ? v.data() - owned : -1;
+    };
+    const ptrdiff_t keySrc = ownedOffset(key), valSrc = ownedOffset(value);
+    ownedBytes.reserve(ownedBytes.size() + key.size() + value.size());
+    if (keySrc >= 0)
+        key = std::string_view(ownedBytes.data() + keySrc, key.size());
+    if (valSrc >= 0)
+        value = std::string_view(ownedBytes.data() + valSrc, value.size());
+
+    const auto keyOff = static_cast<uint32_t>(ownedBytes.size());
+    ownedBytes.append(key);
+    const auto valOff = static_cast<uint32_t>(ownedBytes.size());
+    ownedBytes.append(value);
+    headers.push_back({keyOff, static_cast<uint32_t>(key.size()), valOff, static_cast<uint32_t>(value.size()), hash, true});
 }
 
 /**
- * Add header key-value std::pair to the map (Integer value)
+ * Add header key-value pair to the header table (Integer value)
  * Integer value is converted to a string
  *
  * @param key String representation of the Header Key
  * @param value Integer representation of the Header value
  */
 void HTTPMessage::addHeader(std::string_view key, int32_t value) {
-    auto key_lower = key
-                     | std::views::transform([](unsigned char c){ return std::tolower(c); })
-                     | std::ranges::to<std::string>();
-    headers.try_emplace(std::move(key_lower), std::format("{}", value));
+    char digits[16];
+    auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+    addHeader(key, std::string_view(digits, end - digits));
 }
 
 /**
  * Get Header Value
- * Given a header name (key), return the value associated with it in the headers map
+ * Given a header name (key), return the value associated with it in the header table
  *
- * @param key Key to identify the header
+ * @param key Key to identify the header, in any case
+ * @return Copy of the value, empty if there is no such header
  */
 std::string HTTPMessage::getHeaderValue(std::string_view key) const {
-    // All keys are stored lowercase (normalized at insertion), so lowercase the lookup key once
-    auto key_lower = key
-                     | std::views::transform([](unsigned char c){ return std::tolower(c); })
-                     | std::ranges::to<std::string>();
+    return std::string(getHeaderView(key));
+}
 
-    auto it = headers.find(key_lower);
-    return (it != headers.end()) ? it->second : "";
+/**
+ * Get Header View
+ * Given a header name (key), return the value associated with it without copying or allocating
+ *
+ * @param key Key to identify the header, in any case
+ * @return View of the value, empty if there is no such header. Invalidated by changes to the headers or message bytes
+ */
+std::string_view HTTPMessage::getHeaderView(std::string_view key) const {
+    const HeaderField* h = findHeader(key, headerHash(key));
+    return h != nullptr ? headerValue(*h) : std::string_view();
 }
 
 /**
  * Get Header String
- * Get the full formatted header string "Header: value" from the headers map at position index
+ * Get the full formatted header string "Header: value" from the header table at position index
  *
- * @param index Position in the headers map to retrieve a formatted header string
+ * @param index Position in the header table to retrieve a formatted header string
  * @ret Formatted string with header name and value
  */
 std::string HTTPMessage::getHeaderStr(int32_t index) const {
-    int32_t i = 0;
-    std::string ret = "";
-    for (auto const &[key, value] : headers) {
-        if (i == index) {
-            ret = std::format("{}: {}", key, value);
-            break;
-        }
+    if (index < 0 || static_cast<size_t>(index) >= headers.size())
+        return "";
 
-        i++;
-    }
-    return ret;
+    const HeaderField& h = headers[index];
+    return std::format("{}: {}", headerKey(h), headerValue(h));
 }
 
 /**
  * Get Number of Headers
- * Return the number of headers in the headers map
+ * Return the number of headers in the header table
  *
- * @return size of the map
+ * @return size of the table
  */
 uint32_t HTTPMessage::getNumHeaders() const {
     return headers.size();
@@ -372,8 +494,53 @@ uint32_t HTTPMessage::getNumHeaders() const {
 
 /**
  * Clear Headers
- * Removes all headers from the internal map
+ * Removes all headers from the header table
  */
 void HTTPMessage::clearHeaders() {
     headers.clear();
+    ownedBytes.clear();
+}
+
+/**
+ * Clear
+ * Clear the message bytes like ByteBuffer::clear(). Headers that were referencing them are copied out first
+ */
+void HTTPMessage::clear() {
+    ownHeaders();
+    ByteBuffer::clear();
+}
+
+std::string_view HTTPMessage::headerKey(const HeaderField& h) const {
+    const char* src = h.owned ? ownedBytes.data() : reinterpret_cast<const char*>(ByteBuffer::data());
+    return std::string_view(src + h.keyOff, h.keyLen);
+}
+
+std::string_view HTTPMessage::headerValue(const HeaderField& h) const {
+    const char* src = h.owned ? ownedBytes.data() : reinterpret_cast<const char*>(ByteBuffer::data());
+    return std::string_view(src + h.valOff, h.valLen);
+}
+
+// Linear scan over the flat table: the hash comparison rejects almost every entry without touching the key bytes
+const HTTPMessage::HeaderField* HTTPMessage::findHeader(std::string_view key, uint32_t hash) const {
+    for (const HeaderField& h : headers) {
+        if (h.hash == hash && equalsIgnoreCase(headerKey(h), key))
+            return &h;
+    }
+    return nullptr;
+}
+
+// Copy every header that points into the message bytes into ownedBytes, before those bytes are overwritten
+void HTTPMessage::ownHeaders() {
+    for (HeaderField& h : headers) {
+        if (h.owned)
+            continue;
+
+        const std::string_view key = headerKey(h);
+        const std::string_view value = headerValue(h);
+        h.keyOff = static_cast<uint32_t>(ownedBytes.size());
+        ownedBytes.append(key);
+        h.valOff = static_cast<uint32_t>(ownedBytes.size());
+        ownedBytes.append(value);
+        h.owned = true;
+    }
 }
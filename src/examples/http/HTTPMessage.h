@@ -21,13 +21,16 @@
 
 #include <array>
 #include <cstring>
-#include <map>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "../../ByteBuffer.hpp"
 
+class HTTPChunkedDecoder;
+
 // Constants
 constexpr std::string HTTP_VERSION_10 = "HTTP/1.0";
 constexpr std::string HTTP_VERSION_11 = "HTTP/1.1";
@@ -36,6 +39,12 @@ constexpr uint32_t NUM_METHODS = 9;
 constexpr uint32_t INVALID_METHOD = 9999;
 static_assert(NUM_METHODS < INVALID_METHOD, "INVALID_METHOD must be greater than NUM_METHODS");
 
+// Parsing limits
+constexpr uint32_t MAX_HEADERS = 128;
+constexpr uint32_t MAX_LINE_SIZE = 16384; // 16 KB cap on a single line while it is still incomplete
+constexpr uint32_t MAX_MULTILINE_SIZE = 16384; // 16 KB cap on accumulated multiline header value
+constexpr uint32_t MAX_CONTENT_LENGTH = 256u * 1024u * 1024u; // 256 MB
+
 // HTTP Methods (Requests)
 
 enum Method {
@@ -84,7 +93,26 @@ enum Status {
 
 class HTTPMessage : public ByteBuffer {
 private:
-    std::map<std::string, std::string, std::less<>> headers;
+    // Header table entry. Key and value are (offset, length) slices of the message's own bytes when they came from
+    // them (ie. parsed in place), otherwise of ownedBytes
+    struct HeaderField {
+        uint32_t keyOff;
+        uint32_t keyLen;
+        uint32_t valOff;
+        uint32_t valLen;
+        uint32_t hash; // Case-insensitive hash of the key
+        bool owned;
+    };
+
+    // Flat table in insertion order. Lookups compare the stored hashes first, so they neither allocate nor chase
+    // pointers. Both containers allocate from the message's memory resource
+    std::pmr::vector<HeaderField> headers{getMemoryResource()};
+    std::pmr::string ownedBytes{getMemoryResource()}; // Headers that don't point into the message bytes
+
+    std::string_view headerKey(const HeaderField& h) const;
+    std::string_view headerValue(const HeaderField& h) const;
+    const HeaderField* findHeader(std::string_view key, uint32_t hash) const;
+    void ownHeaders();
 
 public:
     std::string parseErrorStr = "";
@@ -97,12 +125,17 @@ public:
 
 public:
     HTTPMessage();
-    explicit HTTPMessage(std::string const& sData);
-    explicit HTTPMessage(const uint8_t* pData, uint32_t len);
+    explicit HTTPMessage(std::pmr::memory_resource* mr); // Storage for the message bytes comes from mr, ie. a per-connection arena
+    explicit HTTPMessage(std::string const& sData, std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+    explicit HTTPMessage(const uint8_t* pData, uint32_t len, std::pmr::memory_resource* mr = std::pmr::get_default_resource());
     ~HTTPMessage() override = default;
 
     virtual std::unique_ptr<uint8_t[]> create() = 0;
     virtual bool parse() = 0;
+    virtual bool parseStartLine(std::string_view line) = 0; // Request line or status line, without the CRLF
+    virtual bool expectsBody() const { // Whether a body may follow the headers
+        return true;
+    }
 
     // Create helpers
     void putLine(std::string_view str = "", bool crlf_end = true);
@@ -110,19 +143,30 @@ public:
 
     // Parse helpers
     std::string getLine();
+    std::string_view getLineView(); // getLine() without the copy: a view of the message bytes
     std::string getStrElement(char delim = 0x20); // 0x20 = "space"
     bool parseHeaders();
     bool parseBody();
-
-    // Header Map manipulation
+    bool parseContentLength(uint32_t& contentLen); // Validated Content-Length header, 0 if there is none
+    bool parseChunkedBody();
+    void setChunkedBody(uint32_t start, HTTPChunkedDecoder const& decoder);
+    bool isChunked() const; // Transfer-Encoding ends with chunked
+
+    // Header table manipulation. Header names are case-insensitive; if a name is added twice the first value is kept.
+    // Keys and values that lie inside the message's bytes are referenced instead of copied, so they stay valid only
+    // while those bytes do: clear() (and create()) keep them, but resize()/compact()/splice() through a ByteBuffer
+    // reference don't
     void addHeader(std::string_view line);
     void addHeader(std::string_view key, std::string_view value);
     void addHeader(std::string_view key, int32_t value);
     std::string getHeaderValue(std::string_view key) const;
+    std::string_view getHeaderView(std::string_view key) const; // Like getHeaderValue() without a copy. Invalidated by changes to the headers or the message bytes
     std::string getHeaderStr(int32_t index) const;
     uint32_t getNumHeaders() const;
     void clearHeaders();
 
+    void clear(); // ByteBuffer::clear(), keeping the headers that point into the old bytes
+
     // Getters & Setters
 
     std::string getParseError() const {
@@ -0,0 +1,224 @@
+/**
+ ByteBuffer
+ HTTPParser.cpp
+ Copyright 2011-2025 Ramsey Kant
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "HTTPParser.h"
+
+#include <memory>
+
+/**
+ * Feed
+ * Append the next piece of the message to the message's buffer and parse as far as possible
+ *
+ * @param bytes Bytes received since the last call
+ * @return Complete once the whole message has been parsed, NeedMore if it is still incomplete, Error if it is invalid
+ */
+HTTPParser::Result HTTPParser::feed(std::span<const uint8_t> bytes) {
+    if (state == State::Failed)
+        return Result::Error;
+
+    if (!bytes.empty())
+        msg.putBytes(bytes.data(), bytes.size());
+    return feed();
+}
+
+/**
+ * Feed
+ * Parse as far as possible through bytes that were written into the message's buffer directly
+ *
+ * @return Complete once the whole message has been parsed, NeedMore if it is still incomplete, Error if it is invalid
+ */
+HTTPParser::Result HTTPParser::feed() {
+    while (state != State::Done && state != State::Failed) {
+        if (state == State::Body) {
+            if (msg.size() - msg.getReadPos() < bodyLen)
+                return Result::NeedMore;
+
+            if (bodyLen > 0) {
+                msg.data = std::make_unique<uint8_t[]>(bodyLen);
+                msg.getBytes(msg.data.get(), bodyLen);
+                msg.dataLen = bodyLen;
+            }
+            state = State::Done;
+            break;
+        }
+
+        if (state == State::Chunked) {
+            auto res = chunked.decode(std::span<uint8_t>(msg.writableData() + bodyStart, msg.size() - bodyStart), &msg);
+            if (res == HTTPChunkedDecoder::Result::NeedMore)
+                return Result::NeedMore;
+            if (res == HTTPChunkedDecoder::Result::Error) {
+                fail(chunked.getError());
+                break;
+            }
+
+            msg.setChunkedBody(bodyStart, chunked);
+            state = State::Done;
+            break;
+        }
+
+        std::string_view line;
+        if (!nextLine(line))
+            return state == State::Failed ? Result::Error : Result::NeedMore;
+        if (!processLine(line))
+            state = State::Failed;
+    }
+
+    return state == State::Done ? Result::Complete : Result::Error;
+}
+
+/**
+ * Next Line
+ * Find the next complete line, starting the search where the last one left off. The returned view points into the
+ * message's buffer and is consumed (the read position moves past its LF)
+ *
+ * @param line Set to the line, without CR or LF
+ * @return True if a complete line was available
+ */
+bool HTTPParser::nextLine(std::string_view& line) {
+    const uint32_t start = msg.getReadPos();
+    const int64_t lf = msg.find<uint8_t>('\n', scanPos);
+    if (lf < 0) {
+        scanPos = msg.size();
+        if (scanPos - start > MAX_LINE_SIZE)
+            return fail("Line exceeds maximum size");
+        return false;
+    }
+
+    // HTTPMessage::data (the body) hides ByteBuffer::data()
+    const uint8_t* bytes = static_cast<const ByteBuffer&>(msg).data();
+    uint32_t end = static_cast<uint32_t>(lf);
+    if (end > start && bytes[end - 1] == '\r')
+        end--;
+
+    line = std::string_view(reinterpret_cast<const char*>(bytes) + start, end - start);
+    scanPos = static_cast<uint32_t>(lf) + 1;
+    msg.setReadPos(scanPos);
+    return true;
+}
+
+/**
+ * Process Line
+ * Advance the state machine by one complete line
+ *
+ * @param line Line without CR or LF
+ * @return False if the line is invalid
+ */
+bool HTTPParser::processLine(std::string_view line) {
+    if (state == State::StartLine) {
+        // Tolerate blank lines ahead of the start line (ie. a stray CRLF after the previous message)
+        if (line.empty())
+            return true;
+        if (!msg.parseStartLine(line))
+            return false;
+        state = State::Headers;
+        return true;
+    }
+
+    // Headers. A blank line ends them
+    if (line.empty()) {
+        if (!pending.empty())
+            msg.addHeader(pending);
+        pending.clear();
+        return finishHeaders();
+    }
+
+    // Case where values are on multiple lines ending with a comma
+    if (!pending.empty()) {
+        if (pending.size() + line.size() > MAX_MULTILINE_SIZE)
+            return fail("Multiline header value exceeds maximum size");
+        pending += line;
+        if (pending.back() != ',') {
+            msg.addHeader(pending);
+            pending.clear();
+        }
+        return true;
+    }
+
+    if (++headerCount > MAX_HEADERS)
+        return fail("Too many headers");
+
+    if (line.back() == ',')
+        pending = line;
+    else
+        msg.addHeader(line);
+    return true;
+}
+
+/**
+ * Finish Headers
+ * Decide what follows the headers: nothing, a chunked body, or a Content-Length body
+ *
+ * @return False if the Content-Length header is invalid
+ */
+bool HTTPParser::finishHeaders() {
+    if (!msg.expectsBody()) {
+        state = State::Done;
+        return true;
+    }
+
+    if (msg.isChunked()) {
+        bodyStart = msg.getReadPos();
+        state = State::Chunked;
+        return true;
+    }
+
+    if (!msg.parseContentLength(bodyLen))
+        return false;
+    state = State::Body;
+    return true;
+}
+
+bool HTTPParser::fail(std::string_view reason) {
+    msg.parseErrorStr = reason;
+    state = State::Failed;
+    return false;
+}
+
+/**
+ * Reset
+ * Prepare to parse the next message from the bytes after the completed one. Parsing resumes at the read position
+ */
+void HTTPParser::reset() {
+    msg.clearHeaders();
+    msg.data.reset();
+    msg.dataLen = 0;
+    msg.parseErrorStr.clear();
+
+    state = State::StartLine;
+    scanPos = msg.getReadPos();
+    headerCount = 0;
+    bodyLen = 0;
+    bodyStart = 0;
+    chunked = HTTPChunkedDecoder();
+    pending.clear();
+}
+
+/**
+ * Drop Consumed
+ * Compact away the bytes of the messages already parsed, so a buffer reused for a whole connection doesn't keep
+ * growing. Only done between messages (nothing of the next one is referenced yet), and it costs a move of just the
+ * incomplete tail, once per parseAll()
+ */
+void HTTPParser::dropConsumed() {
+    const uint32_t consumed = msg.getReadPos();
+    if (state != State::StartLine || consumed == 0)
+        return;
+
+    static_cast<ByteBuffer&>(msg).compact();
+    scanPos -= consumed;
+}
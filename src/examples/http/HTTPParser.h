@@ -0,0 +1,106 @@
+/**
+ ByteBuffer
+ HTTPParser.h
+ Copyright 2011-2025 Ramsey Kant
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef _HTTPPARSER_H_
+#define _HTTPPARSER_H_
+
+#include "HTTPChunked.h"
+#include "HTTPMessage.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// Incremental parser for messages that arrive in pieces (slow clients, partial recv()s). Bytes are appended to the
+// message's own ByteBuffer and parsing resumes where the previous feed() stopped, so no byte is scanned twice.
+// Works for any HTTPMessage: the start line is handed to HTTPMessage::parseStartLine(). A chunked body is decoded in
+// place as it arrives; its trailer fields are added to the headers.
+// Lines end with LF, optionally preceded by CR. Once the message is complete, the message's read position is just
+// past its last byte; any bytes fed beyond that are left unread in the buffer. Those are the start of the next
+// pipelined message: reset() and keep feeding, or let parseAll() do both
+class HTTPParser {
+public:
+    enum class Result {
+        NeedMore, // The message isn't complete yet: feed more bytes
+        Complete,
+        Error // See the message's getParseError()
+    };
+
+    explicit HTTPParser(HTTPMessage& m) : msg(m) {}
+
+    Result feed(std::span<const uint8_t> bytes); // Append bytes to the message and continue parsing
+    Result feed(); // Continue parsing bytes already appended to the message, ie. through prepare()/commit()
+
+    // Parse every complete message in the buffer, in order, calling onMessage(msg) for each. After each call the
+    // message is reset() for the next one, so whatever onMessage needs must be used or copied out before it returns.
+    // Returns NeedMore once the remaining bytes hold no complete message (feed more and call again), or Error
+    template<typename F> Result parseAll(std::span<const uint8_t> bytes, F&& onMessage) {
+        if (state == State::Failed)
+            return Result::Error;
+        if (!bytes.empty())
+            msg.putBytes(bytes.data(), bytes.size());
+        return parseAll(std::forward<F>(onMessage));
+    }
+    template<typename F> Result parseAll(F&& onMessage) {
+        Result r;
+        while ((r = feed()) == Result::Complete) {
+            onMessage(msg);
+            reset();
+        }
+        if (r == Result::NeedMore)
+            dropConsumed();
+        return r;
+    }
+
+    // Start on the next message pipelined behind a complete one: the headers and body are cleared, the bytes that
+    // follow the message (and the read position at their start) are kept
+    void reset();
+
+    bool isComplete() const {
+        return state == State::Done;
+    }
+
+private:
+    enum class State {
+        StartLine,
+        Headers,
+        Body,
+        Chunked,
+        Done,
+        Failed
+    };
+
+    HTTPMessage& msg;
+    State state = State::StartLine;
+    uint32_t scanPos = 0; // Where the search for the next LF resumes
+    uint32_t headerCount = 0;
+    uint32_t bodyLen = 0;
+    uint32_t bodyStart = 0; // First chunk-size line of a chunked body
+    HTTPChunkedDecoder chunked;
+    std::string pending; // Header value continued on the next line (ends with a comma)
+
+    bool nextLine(std::string_view& line);
+    bool processLine(std::string_view line);
+    bool finishHeaders();
+    bool fail(std::string_view reason);
+    void dropConsumed();
+};
+
+#endif
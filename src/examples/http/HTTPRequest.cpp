@@ -22,15 +22,19 @@
 #include <format>
 #include <memory>
 #include <print>
+#include <string_view>
 
 
 HTTPRequest::HTTPRequest() : HTTPMessage() {
 }
 
-HTTPRequest::HTTPRequest(std::string const& sData) : HTTPMessage(sData) {
+HTTPRequest::HTTPRequest(std::pmr::memory_resource* mr) : HTTPMessage(mr) {
 }
 
-HTTPRequest::HTTPRequest(const uint8_t* pData, uint32_t len) : HTTPMessage(pData, len) {
+HTTPRequest::HTTPRequest(std::string const& sData, std::pmr::memory_resource* mr) : HTTPMessage(sData, mr) {
+}
+
+HTTPRequest::HTTPRequest(const uint8_t* pData, uint32_t len, std::pmr::memory_resource* mr) : HTTPMessage(pData, len, mr) {
 }
 
 /**
@@ -113,27 +117,54 @@ std::unique_ptr<uint8_t[]> HTTPRequest::create() {
  * @param True if successful. If false, sets parseErrorStr for reason of failure
  */
 bool HTTPRequest::parse() {
-    // Get elements from the initial line: <method> <path> <version>\r\n
-    std::string methodName = getStrElement();
-    if (methodName.empty()) {
+    // Initial line: <method> <path> <version>\r\n
+    if (!parseStartLine(getLineView()))
+        return false;
+
+    // Parse and populate the headers map using the parseHeaders helper
+    if (!parseHeaders())
+        return false;
+
+    if (!expectsBody())
+        return true;
+
+    // Parse the body of the message
+    if (!parseBody())
+        return false;
+
+    return true;
+}
+
+/**
+ * Parse Start Line
+ * Populate the method, request URI and version from the request line: <method> <path> <version>
+ *
+ * @param line Request line without the CRLF
+ * @return True if successful. If false, sets parseErrorStr for reason of failure
+ */
+bool HTTPRequest::parseStartLine(std::string_view line) {
+    const size_t methodEnd = line.find(' ');
+    if (methodEnd == std::string_view::npos || methodEnd == 0) {
         parseErrorStr = "Empty method";
         return false;
     }
 
     // Convert the name to the internal enumeration number
-    method = methodStrToInt(methodName);
+    method = methodStrToInt(line.substr(0, methodEnd));
     if (method == INVALID_METHOD) {
         parseErrorStr = "Invalid Method";
         return false;
     }
 
-    requestUri = getStrElement();
-    if (requestUri.empty()) {
+    line.remove_prefix(methodEnd + 1);
+    const size_t uriEnd = line.find(' ');
+    if (uriEnd == std::string_view::npos || uriEnd == 0) {
         parseErrorStr = "No request URI";
         return false;
     }
+    requestUri = line.substr(0, uriEnd);
 
-    version = getLine(); // End of the line, pull till \r\n
+    version = line.substr(uriEnd + 1);
     if (version.empty()) {
         parseErrorStr = "HTTP version string was empty";
         return false;
@@ -150,18 +181,15 @@ bool HTTPRequest::parse() {
     //     return false;
     // }
 
-    // Parse and populate the headers map using the parseHeaders helper
-    if (!parseHeaders())
-        return false;
-
-    // Only POST and PUT can have Content (data after headers)
-    if ((method != POST) && (method != PUT))
-        return true;
-
-    // Parse the body of the message
-    if (!parseBody())
-        return false;
-
     return true;
 }
 
+/**
+ * Expects Body
+ * Only POST and PUT can have Content (data after headers)
+ *
+ * @return True if the method carries a body
+ */
+bool HTTPRequest::expectsBody() const {
+    return method == POST || method == PUT;
+}
@@ -30,12 +30,15 @@ private:
 
 public:
     HTTPRequest();
-    explicit HTTPRequest(std::string const& sData);
-    explicit HTTPRequest(const uint8_t* pData, uint32_t len);
+    explicit HTTPRequest(std::pmr::memory_resource* mr); // Storage for the message bytes comes from mr, ie. a per-connection arena
+    explicit HTTPRequest(std::string const& sData, std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+    explicit HTTPRequest(const uint8_t* pData, uint32_t len, std::pmr::memory_resource* mr = std::pmr::get_default_resource());
     ~HTTPRequest() override = default;
 
     std::unique_ptr<uint8_t[]> create() override;
     bool parse() override;
+    bool parseStartLine(std::string_view line) override;
+    bool expectsBody() const override; // Only POST and PUT carry a body
 
     // Helper functions
 
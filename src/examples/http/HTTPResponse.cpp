@@ -27,10 +27,13 @@
 HTTPResponse::HTTPResponse() : HTTPMessage() {
 }
 
-HTTPResponse::HTTPResponse(std::string const& sData) : HTTPMessage(sData) {
+HTTPResponse::HTTPResponse(std::pmr::memory_resource* mr) : HTTPMessage(mr) {
 }
 
-HTTPResponse::HTTPResponse(const uint8_t* pData, uint32_t len) : HTTPMessage(pData, len) {
+HTTPResponse::HTTPResponse(std::string const& sData, std::pmr::memory_resource* mr) : HTTPMessage(sData, mr) {
+}
+
+HTTPResponse::HTTPResponse(const uint8_t* pData, uint32_t len, std::pmr::memory_resource* mr) : HTTPMessage(pData, len, mr) {
 }
 
 /**
@@ -114,6 +117,31 @@ std::unique_ptr<uint8_t[]> HTTPResponse::create() {
     return createRetData;
 }
 
+#ifndef _WIN32
+/**
+ * Create Iov
+ * Serialize the status line and headers into the backing ByteBuffer, then append them and the body to out, so the
+ * whole response can go out in one writev() without the body being copied behind the headers.
+ * The body is borrowed: it must not change until out has been sent
+ *
+ * @param out Chain to append the response to
+ * @return Total size of the response in bytes
+ */
+size_t HTTPResponse::createIov(ByteBufferChain& out) {
+    clear();
+
+    putLine(std::format("{} {} {}", version, status, reason));
+    putHeaders();
+
+    setReadPos(0);
+    out.append(*this);
+    if (this->data && this->dataLen > 0)
+        out.append(std::span<const uint8_t>(this->data.get(), this->dataLen));
+
+    return size() + (this->data ? this->dataLen : 0);
+}
+#endif
+
 /**
  * Parse
  * Populate internal HTTPResponse variables by parsing the HTTP data
@@ -121,12 +149,44 @@ std::unique_ptr<uint8_t[]> HTTPResponse::create() {
  * @param True if successful. If false, sets parseErrorStr for reason of failure
  */
 bool HTTPResponse::parse() {
-    std::string statusstr;
+    // Status line: <version> <status code> <reason>\r\n
+    if (!parseStartLine(getLineView()))
+        return false;
 
-    // Get elements from the status line: <version> <status code> <reason>\r\n
-    version = getStrElement();
-    statusstr = getStrElement();
-    reason = getLine(); // Pull till \r\n termination
+    // Parse and populate the headers map using the parseHeaders helper
+    if (!parseHeaders())
+        return false;
+
+    // If the body of the message
+    if (!parseBody())
+        return false;
+
+    return true;
+}
+
+/**
+ * Parse Start Line
+ * Populate the version, status code and reason from the status line: <version> <status code> <reason>
+ *
+ * @param line Status line without the CRLF
+ * @return True (a malformed status code falls back to matching the reason string)
+ */
+bool HTTPResponse::parseStartLine(std::string_view line) {
+    std::string_view statusstr;
+
+    const size_t versionEnd = line.find(' ');
+    if (versionEnd == std::string_view::npos) {
+        version = "";
+    } else {
+        version = line.substr(0, versionEnd);
+        line.remove_prefix(versionEnd + 1);
+
+        // The reason phrase may be empty, in which case the rest of the line is the status code
+        const size_t statusEnd = line.find(' ');
+        statusstr = line.substr(0, statusEnd);
+        line.remove_prefix(statusEnd == std::string_view::npos ? line.size() : statusEnd + 1);
+    }
+    reason = line;
 
     // Parse the status code integer directly; fall back to reason-string matching if malformed
     int32_t code = 0;
@@ -143,15 +203,5 @@ bool HTTPResponse::parse() {
     //     return false;
     // }
 
-    // Parse and populate the headers map using the parseHeaders helper
-    if (!parseHeaders())
-        return false;
-
-    // If the body of the message
-    if (!parseBody())
-        return false;
-
     return true;
 }
-
-
@@ -20,6 +20,7 @@
 #define _HTTPRESPONSE_H_
 
 #include "HTTPMessage.h"
+#include "../../ByteBufferChain.hpp"
 
 #include <memory>
 
@@ -34,12 +35,17 @@ private:
 
 public:
     HTTPResponse();
-    explicit HTTPResponse(std::string const& sData);
-    explicit HTTPResponse(const uint8_t* pData, uint32_t len);
+    explicit HTTPResponse(std::pmr::memory_resource* mr); // Storage for the message bytes comes from mr, ie. a per-connection arena
+    explicit HTTPResponse(std::string const& sData, std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+    explicit HTTPResponse(const uint8_t* pData, uint32_t len, std::pmr::memory_resource* mr = std::pmr::get_default_resource());
     ~HTTPResponse() override = default;
 
     std::unique_ptr<uint8_t[]> create() override;
+#ifndef _WIN32
+    size_t createIov(ByteBufferChain& out); // Like create(), but gathers the headers and body for writev() without copying them together
+#endif
     bool parse() override;
+    bool parseStartLine(std::string_view line) override;
 
     // Accessors & Mutators
     void setStatus (int32_t scode) {
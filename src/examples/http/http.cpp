@@ -17,12 +17,16 @@
  */
 
 #include "../../ByteBuffer.hpp"
+#include "../../ConstByteBuffer.hpp"
+#include "HTTPChunked.h"
+#include "HTTPParser.h"
 #include "HTTPRequest.h"
 #include "HTTPResponse.h"
 
 #include <cstring>
 #include <format>
 #include <memory>
+#include <memory_resource>
 #include <print>
 
 using namespace std;
@@ -55,6 +59,17 @@ int32_t main() {
         check(l2.size() == 5, "l2 length == 5");
         check(l3.size() == 5, "l3 length == 5");
         check(l4.size() == 0, "l4 length == 0");
+
+        // Views straight into the message bytes. A blank line after LF is not swallowed
+        auto msg2 = std::make_unique<HTTPRequest>(string(100, 'h') + "\r\n\nx\rlast");
+        string_view v1 = msg2->getLineView();
+        string_view v2 = msg2->getLineView();
+        string_view v3 = msg2->getLineView();
+        check(v1 == string(100, 'h') && (const uint8_t*)v1.data() == static_cast<const ByteBuffer&>(*msg2).data(),
+              "getLineView long line without a copy");
+        check(v2.empty() && v3 == "x", "getLineView blank line then lone CR");
+        const uint32_t before = msg2->getReadPos();
+        check(msg2->getLineView().empty() && msg2->getReadPos() == before, "incomplete line leaves the position alone");
     }
 
     // --- HTTPRequest parse(): POST with body ---
@@ -229,6 +244,292 @@ int32_t main() {
         check(std::strncmp((const char*)parsedData, body.c_str(), body.size()) == 0,   "round-trip body content");
     }
 
+#ifndef _WIN32
+    // --- HTTPResponse createIov() ---
+    std::print("== HTTPResponse createIov() ==\n");
+    {
+        const string body = "<html>gathered</html>";
+        auto res = std::make_unique<HTTPResponse>();
+        res->setStatus(Status(OK));
+        res->addHeader("Content-Length", (int32_t)body.size());
+        res->setData((uint8_t*)body.c_str(), body.size());
+
+        auto flat = res->create();
+        const uint32_t flatSize = res->size();
+
+        ByteBufferChain chain;
+        size_t total = res->createIov(chain);
+        check(total == flatSize && chain.totalBytes() == flatSize, "createIov total matches create()");
+        check(chain.iovecs().size() == 2, "createIov: headers and body are separate iovecs");
+
+        string gathered;
+        for (const iovec& v : chain.iovecs())
+            gathered.append((const char*)v.iov_base, v.iov_len);
+        check(gathered == string((const char*)flat.get(), flatSize), "createIov bytes match create()");
+    }
+#endif
+
+    // --- Incremental parsing of partial reads ---
+    std::print("== HTTPParser feed() ==\n");
+    {
+        const string raw =
+            "POST /upload HTTP/1.1\r\n"
+            "Host: example.com\r\n"
+            "Accept: text/html,\r\n"
+            " text/plain\r\n"
+            "Content-Length: 11\r\n"
+            "\r\n"
+            "hello world";
+
+        // One byte at a time, like the slowest possible client
+        HTTPRequest req;
+        HTTPParser parser(req);
+        HTTPParser::Result r = HTTPParser::Result::NeedMore;
+        size_t fed = 0;
+        for (; fed < raw.size() && r == HTTPParser::Result::NeedMore; fed++)
+            r = parser.feed(std::span((const uint8_t*)raw.data() + fed, 1));
+        check(r == HTTPParser::Result::Complete && fed == raw.size(), "byte-at-a-time feed completes on the last byte");
+        check(req.getMethod() == POST && req.getRequestUri() == "/upload" && req.getVersion() == "HTTP/1.1",
+              "fed request line");
+        check(req.getNumHeaders() == 3 && req.getHeaderValue("host") == "example.com", "fed headers");
+        check(req.getHeaderValue("Accept") == "text/html, text/plain", "fed multiline header");
+        check(req.getDataLength() == 11 && std::memcmp(req.getData(), "hello world", 11) == 0, "fed body");
+        check(req.getReadPos() == raw.size(), "read position ends at the end of the message");
+
+        // Split in the middle of the CRLF and of the body
+        HTTPRequest req2;
+        HTTPParser parser2(req2);
+        const size_t cut1 = raw.find("\r\n") + 1, cut2 = raw.size() - 3;
+        check(parser2.feed(std::span((const uint8_t*)raw.data(), cut1)) == HTTPParser::Result::NeedMore, "split CRLF needs more");
+        check(parser2.feed(std::span((const uint8_t*)raw.data() + cut1, cut2 - cut1)) == HTTPParser::Result::NeedMore,
+              "partial body needs more");
+        check(parser2.feed(std::span((const uint8_t*)raw.data() + cut2, raw.size() - cut2)) == HTTPParser::Result::Complete &&
+              parser2.isComplete(), "last piece completes");
+        check(req2.getDataLength() == 11, "split body length");
+
+        // GET has no body; bytes after the blank line are left for the next message
+        const string get = "GET / HTTP/1.1\nHost: a\n\nGET /next";
+        HTTPRequest req3;
+        HTTPParser parser3(req3);
+        check(parser3.feed(std::span((const uint8_t*)get.data(), get.size())) == HTTPParser::Result::Complete,
+              "LF-only GET completes");
+        check(req3.bytesRemaining() == 9, "trailing bytes left unread");
+
+        // Responses go through the same parser
+        const string res = "HTTP/1.1 404 Not Found\r\nContent-Length: 2\r\n\r\nno";
+        HTTPResponse resp;
+        HTTPParser parser4(resp);
+        check(parser4.feed(std::span((const uint8_t*)res.data(), res.size())) == HTTPParser::Result::Complete &&
+              resp.getReason() == "Not Found" && resp.getDataLength() == 2, "fed response");
+
+        // Errors
+        const string bad = "BREW /pot HTTP/1.1\r\n";
+        HTTPRequest req5;
+        HTTPParser parser5(req5);
+        check(parser5.feed(std::span((const uint8_t*)bad.data(), bad.size())) == HTTPParser::Result::Error &&
+              req5.getParseError() == "Invalid Method", "invalid method is an error");
+        check(parser5.feed(std::span((const uint8_t*)"x", 1)) == HTTPParser::Result::Error, "errors are final");
+
+        HTTPRequest req6;
+        HTTPParser parser6(req6);
+        const string endless(MAX_LINE_SIZE + 1, 'a');
+        check(parser6.feed(std::span((const uint8_t*)endless.data(), endless.size())) == HTTPParser::Result::Error,
+              "unterminated line over the limit is an error");
+    }
+
+    // --- Header table referencing the message bytes ---
+    std::print("== Header table ==\n");
+    {
+        // All of the message's storage, header table included, comes from a stack arena that can't fall back to the heap
+        alignas(std::max_align_t) uint8_t stack[8192];
+        std::pmr::monotonic_buffer_resource arena(stack, sizeof(stack), std::pmr::null_memory_resource());
+        HTTPRequest req(&arena);
+
+        string raw = "GET /h HTTP/1.1\r\n";
+        for (int i = 0; i < 20; i++)
+            raw += std::format("X-Header-{}: value {}\r\n", i, i);
+        raw += "Host: example.com\r\nhost: duplicate\r\n\r\n";
+
+        HTTPParser parser(req);
+        check(parser.feed(std::span((const uint8_t*)raw.data(), raw.size())) == HTTPParser::Result::Complete,
+              "22 header request parses from the arena");
+        check(req.getNumHeaders() == 21, "duplicate header name ignored");
+        check(req.getHeaderView("HOST") == "example.com", "case-insensitive lookup keeps the first value");
+        check(req.getHeaderView("x-header-13") == "value 13", "lookup in a 20 header table");
+        check(req.getHeaderView("X-Missing").empty(), "missing header is empty");
+
+        const uint8_t* bytes = static_cast<const ByteBuffer&>(req).data();
+        const auto* v = (const uint8_t*)req.getHeaderView("X-Header-0").data();
+        check(v >= bytes && v < bytes + req.size(), "parsed values point into the message bytes");
+        check(req.getHeaderStr(0) == "X-Header-0: value 0", "insertion order and case kept");
+
+        req.clear();
+        check(req.getHeaderValue("x-header-19") == "value 19", "headers survive clear()");
+        req.putHeaders();
+        check(req.size() > 0 && req.find<uint8_t>('X') == 0, "headers written back in order");
+
+        // A copied header's value can come from the table itself, even when adding it grows the owned bytes
+        HTTPResponse res;
+        const string longValue(200, 'v');
+        res.addHeader("A", longValue);
+        for (int i = 0; i < 8; i++)
+            res.addHeader(std::format("Copy-{}", i), res.getHeaderView(i == 0 ? "A" : std::format("Copy-{}", i - 1)));
+        check(res.getHeaderView("Copy-7") == longValue, "header added from getHeaderView()");
+        res.addHeader(res.getHeaderView("A").substr(0, 3), "self-keyed");
+        check(res.getHeaderView("vvv") == "self-keyed", "header key from getHeaderView()");
+    }
+
+    // --- Chunked transfer-encoding ---
+    std::print("== Chunked transfer-encoding ==\n");
+    {
+        const string pieces[] = {"hello", ", chunked", "", " world!"};
+        const std::pair<std::string_view, std::string_view> trailers[] = {{"X-Checksum", "abc123"}};
+
+        HTTPResponse res;
+        res.setStatus(Status(OK));
+        res.addHeader("Transfer-Encoding", "gzip, Chunked");
+        res.create();
+        for (auto const& p : pieces)
+            putChunk(res, std::span((const uint8_t*)p.data(), p.size()));
+        putLastChunk(res, trailers);
+        const string encoded((const char*)static_cast<const ByteBuffer&>(res).data(), res.size());
+        check(encoded.ends_with("\r\n5\r\nhello\r\n9\r\n, chunked\r\n7\r\n world!\r\n0\r\nX-Checksum: abc123\r\n\r\n"),
+              "chunks framed with hex sizes, empty piece skipped");
+
+        HTTPResponse parsed(encoded);
+        check(parsed.parse(), std::format("chunked response parses (error: {})", parsed.getParseError()));
+        check(parsed.getDataLength() == 21 && std::memcmp(parsed.getData(), "hello, chunked world!", 21) == 0,
+              "chunked body joined");
+        check(parsed.getHeaderValue("x-checksum") == "abc123", "trailer added to the headers");
+        check(parsed.bytesRemaining() == 1, "read position stops after the last chunk");
+
+        // One byte at a time through the incremental parser
+        HTTPResponse fed;
+        HTTPParser parser(fed);
+        HTTPParser::Result r = HTTPParser::Result::NeedMore;
+        size_t n = 0;
+        for (; n < encoded.size() && r == HTTPParser::Result::NeedMore; n++)
+            r = parser.feed(std::span((const uint8_t*)encoded.data() + n, 1));
+        check(r == HTTPParser::Result::Complete && n == encoded.size(), "byte-at-a-time chunked feed completes on the last byte");
+        check(fed.getDataLength() == 21 && std::memcmp(fed.getData(), "hello, chunked world!", 21) == 0, "fed chunked body");
+        check(fed.getHeaderValue("X-Checksum") == "abc123" && fed.getReadPos() == encoded.size(), "fed trailer");
+
+        // Chunk extensions are ignored, bad sizes are rejected
+        HTTPResponse ext("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n3;name=value\r\nabc\r\n0\r\n\r\n");
+        check(ext.parse() && ext.getDataLength() == 3, "chunk extension ignored");
+        HTTPResponse bad("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\nabc\r\n0\r\n\r\n");
+        check(!bad.parse() && bad.getParseError() == "Invalid chunk size", "invalid chunk size rejected");
+        HTTPResponse cut("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nabc");
+        check(!cut.parse() && cut.getParseError() == "Incomplete chunked body", "truncated chunked body rejected");
+        HTTPResponse notLast("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked, gzip\r\nContent-Length: 2\r\n\r\nab");
+        check(!notLast.isChunked(), "chunked must be the last coding");
+
+#ifndef _WIN32
+        ByteBufferChain chain;
+        for (auto const& p : pieces)
+            appendChunk(chain, std::span((const uint8_t*)p.data(), p.size()));
+        appendLastChunk(chain);
+        string gathered;
+        for (const iovec& v : chain.iovecs())
+            gathered.append((const char*)v.iov_base, v.iov_len);
+        check(gathered == "5\r\nhello\r\n9\r\n, chunked\r\n7\r\n world!\r\n0\r\n\r\n", "chained chunks match");
+#endif
+    }
+
+    // --- Pipelined requests ---
+    std::print("== Pipelining ==\n");
+    {
+        // parse() stops at the end of Content-Length and leaves the next request unread
+        HTTPRequest two("POST /a HTTP/1.1\r\nContent-Length: 3\r\n\r\nabcGET /b HTTP/1.1\r\nHost: x\r\n\r\n");
+        check(two.parse(), std::format("first pipelined request parses (error: {})", two.getParseError()));
+        check(two.getDataLength() == 3 && std::memcmp(two.getData(), "abc", 3) == 0, "first body stops at Content-Length");
+        const std::string_view rest((const char*)static_cast<const ByteBuffer&>(two).data() + two.getReadPos(), 4);
+        check(rest == "GET ", "read position at the start of the next request");
+
+        // A body one byte short is rejected, not filled with a byte from past the end
+        const string shortRaw = "POST / HTTP/1.1\r\nContent-Length: 5\r\n\r\nabcd";
+        HTTPRequest shortBody((const uint8_t*)shortRaw.data(), shortRaw.size()); // No trailing null, unlike HTTPRequest(string)
+        check(!shortBody.parse() && shortBody.getDataLength() == 0, "body one byte short of Content-Length rejected");
+
+        // Pipelined behind a short body, the next request's bytes are taken as the rest of the body: the next parse
+        // then fails instead of a truncated body being passed off as a whole message
+        HTTPRequest shortThenNext("POST / HTTP/1.1\r\nContent-Length: 5\r\n\r\nabcdGET /b HTTP/1.1\r\n\r\n");
+        check(shortThenNext.parse() && std::memcmp(shortThenNext.getData(), "abcdG", 5) == 0,
+              "short body followed by a pipelined request reads Content-Length bytes");
+        HTTPParser nextParser(shortThenNext);
+        nextParser.reset();
+        check(nextParser.feed() == HTTPParser::Result::Error, "the damaged request after it is rejected");
+
+        // 50 GETs from one recv(), then a POST split across two
+        string batch;
+        for (int i = 0; i < 50; i++)
+            batch += std::format("GET /item/{} HTTP/1.1\r\nHost: example.com\r\n\r\n", i);
+        const string post = "POST /last HTTP/1.1\r\nContent-Length: 4\r\n\r\ndone";
+        batch += post.substr(0, 10);
+
+        HTTPRequest req;
+        HTTPParser parser(req);
+        int seen = 0;
+        bool inOrder = true;
+        auto onRequest = [&](HTTPMessage& m) {
+            auto& r = static_cast<HTTPRequest&>(m);
+            if (seen < 50)
+                inOrder = inOrder && r.getMethod() == GET && r.getRequestUri() == std::format("/item/{}", seen) &&
+                          r.getNumHeaders() == 1 && r.getHeaderValue("Host") == "example.com";
+            else
+                inOrder = inOrder && r.getMethod() == POST && r.getDataLength() == 4 && std::memcmp(r.getData(), "done", 4) == 0;
+            seen++;
+        };
+        check(parser.parseAll(std::span((const uint8_t*)batch.data(), batch.size()), onRequest) == HTTPParser::Result::NeedMore &&
+              seen == 50, "one pass yields all 50 complete GETs");
+        check(req.size() == 10 && req.getReadPos() == 0, "parsed requests compacted away, partial POST kept");
+        check(parser.parseAll(std::span((const uint8_t*)post.data() + 10, post.size() - 10), onRequest) ==
+              HTTPParser::Result::NeedMore && seen == 51, "split POST completes on the next read");
+        check(inOrder, "pipelined requests yielded in order with their own headers and bodies");
+        check(req.size() == 0, "nothing left over");
+
+        const string badBatch = "GET / HTTP/1.1\r\n\r\nBREW / HTTP/1.1\r\n\r\n";
+        HTTPRequest req2;
+        HTTPParser parser2(req2);
+        int seen2 = 0;
+        check(parser2.parseAll(std::span((const uint8_t*)badBatch.data(), badBatch.size()), [&](HTTPMessage&) { seen2++; }) ==
+              HTTPParser::Result::Error && seen2 == 1, "batch stops at an invalid request");
+    }
+
+    // --- Canned response built at compile time ---
+    std::print("== Compile-time canned response ==\n");
+    {
+        static constexpr auto notFound = [] {
+            ConstByteBuffer<128> b;
+            b.putLine("HTTP/1.1 404 Not Found");
+            b.putLine("Content-Type: text/plain");
+            b.putLine("Content-Length: 9");
+            b.putLine();
+            b.putString("not found");
+            return b;
+        }();
+        static_assert(notFound.ok(), "canned response fits");
+
+        HTTPResponse res(notFound.data(), notFound.size());
+        check(res.parse(), std::format("canned response parses (error: {})", res.getParseError()));
+        check(res.getReason() == "Not Found", "canned response status");
+        check(res.getDataLength() == 9 && std::memcmp(res.getData(), "not found", 9) == 0, "canned response body");
+    }
+
+    // --- Messages backed by a per-connection arena ---
+    std::print("== HTTPRequest arena ==\n");
+    {
+        std::pmr::monotonic_buffer_resource arena(8192);
+        std::string raw = "GET /index.html HTTP/1.1\r\nHost: example.com\r\n\r\n";
+        HTTPRequest req(raw, &arena);
+        check(req.getMemoryResource() == &arena, "HTTPRequest(sData, mr) uses the arena");
+        check(req.parse(), std::format("arena-backed request parses (error: {})", req.getParseError()));
+        check(req.getRequestUri() == "/index.html", "arena-backed request URI");
+
+        HTTPResponse res(&arena);
+        check(res.getMemoryResource() == &arena, "HTTPResponse(mr) uses the arena");
+    }
+
     if (failures == 0) {
         std::print("\nAll tests PASSED\n");
         return 0;
@@ -20,16 +20,24 @@
  * are created and parsed by a server's packet parsing function. For simplicity, actual socket code has been omitted
  */
 
+#include <cstring>
 #include <memory>
 #include <print>
 #include <string>
 #include "../../ByteBuffer.hpp"
+#include "../../ByteBufferPool.hpp"
+#include "../../ByteBufferView.hpp"
+#include "../../FixedByteBuffer.hpp"
 
 using namespace std;
 
-ByteBuffer* createLoginPacket(int32_t version, string username, string password);
-ByteBuffer* createChatMsgPacket(string name, string msg);
-void serverParser(ByteBuffer* pkt);
+struct MoveBody;
+
+ByteBufferPool::Lease createLoginPacket(int32_t version, string username, string password);
+void writeLoginPacket(ByteBuffer& pkt, int32_t version, const string& username, const string& password);
+ByteBufferPool::Lease createChatMsgPacket(string name, string msg);
+ByteBufferPool::Lease createMovePacket(const MoveBody& move);
+template<typename Packet> void serverParser(Packet& pkt);
 bool verifyLoginPacket(ByteBuffer* pkt, int32_t expVersion, const string& expUsername, const string& expPassword);
 bool verifyChatMsgPacket(ByteBuffer* pkt, const string& expName, const string& expMsg);
 
@@ -40,7 +48,17 @@ enum Opcode {
    LOGIN = 0x0001,
    DISCONNECT = 0x0002,
    MESSAGE = 0x0003,
-   UNKNOWN = 0x0004
+   UNKNOWN = 0x0004,
+   MOVE = 0x0005
+};
+
+/**
+ * Body of a move packet. Fixed-size messages like this one are written and read as a whole with put(obj) and
+ * get<T>(), so the encoder and decoder can't drift apart
+ */
+struct MoveBody {
+   uint32_t playerId;
+   float x, y, z;
 };
 
 /**
@@ -50,26 +68,37 @@ enum Opcode {
  * @param version Client's version number to send to the server
  * @param username Username of client logging in
  * @param password Password of client logging in
- * @return A pointer to a byte array ready to be sent over the wire
+ * @return A leased ByteBuffer ready to be sent over the wire. Goes back to this thread's pool once released
  */
-ByteBuffer* createLoginPacket(int32_t version, string username, string password) {
-   ByteBuffer* pkt = new ByteBuffer(100);
+ByteBufferPool::Lease createLoginPacket(int32_t version, string username, string password) {
+   auto pkt = ByteBufferPool::local().acquire(100);
+   writeLoginPacket(*pkt, version, username, password);
+   return pkt;
+}
 
+/**
+ * Write login packet
+ * Write a login packet into any buffer, ie. a FixedByteBuffer on the stack so a short login costs no allocations
+ *
+ * @param pkt Buffer to append the packet to
+ * @param version Client's version number to send to the server
+ * @param username Username of client logging in
+ * @param password Password of client logging in
+ */
+void writeLoginPacket(ByteBuffer& pkt, int32_t version, const string& username, const string& password) {
    // Write the opcode as the first bytes of the packet (login)
-   pkt->putShort(Opcode(LOGIN));
+   pkt.putShort(Opcode(LOGIN));
 
    // Version #
-   pkt->putInt(version);
+   pkt.putInt(version);
 
    // Size & Contents of null terminated username string
-   pkt->putInt(username.size()+1);
-   pkt->putBytes((uint8_t*)username.c_str(), username.size()+1);
+   pkt.putInt(username.size()+1);
+   pkt.putBytes((uint8_t*)username.c_str(), username.size()+1);
 
    // Size & Contents of null terminated password string
-   pkt->putInt(password.size()+1);
-   pkt->putBytes((uint8_t*)password.c_str(), password.size()+1);
-
-   return pkt;
+   pkt.putInt(password.size()+1);
+   pkt.putBytes((uint8_t*)password.c_str(), password.size()+1);
 }
 
 /**
@@ -78,10 +107,10 @@ ByteBuffer* createLoginPacket(int32_t version, string username, string password)
  *
  * @param name Name of user sending the chat message
  * @param msg String containing the content of the chat message
- * @return A pointer to a ByteBuffer ready to be sent over the wire
+ * @return A leased ByteBuffer ready to be sent over the wire. Goes back to this thread's pool once released
  */
-ByteBuffer* createChatMsgPacket(string name, string msg) {
-   ByteBuffer* pkt = new ByteBuffer();
+ByteBufferPool::Lease createChatMsgPacket(string name, string msg) {
+   auto pkt = ByteBufferPool::local().acquire(name.size() + msg.size() + 12);
 
    // Write the opcode as the first bytes of the packet (message)
    pkt->putShort(Opcode(MESSAGE));
@@ -97,19 +126,36 @@ ByteBuffer* createChatMsgPacket(string name, string msg) {
    return pkt;
 }
 
+/**
+ * Move packet
+ * Create a packet telling the server where a player moved to
+ *
+ * @param move Player and new position
+ * @return A leased ByteBuffer ready to be sent over the wire. Goes back to this thread's pool once released
+ */
+ByteBufferPool::Lease createMovePacket(const MoveBody& move) {
+   auto pkt = ByteBufferPool::local().acquire(2 + bb_reflect::encodedSize<MoveBody>());
+
+   pkt->putShort(Opcode(MOVE));
+   pkt->put(move);
+
+   return pkt;
+}
+
 /**
  * Packet Parser
  * This fictitious packet parser on the "server" reads the ByteBuffer'd packets and prints out
  * information about each packet it understands according to the networking protocol.
+ * Works on an owning ByteBuffer or directly on the receive buffer through a ByteBufferView
  *
- * @param pkt A pointer to a ByteBuffer containing the packet data
+ * @param pkt A ByteBuffer or ByteBufferView containing the packet data
  */
-void serverParser(ByteBuffer* pkt) {
-   std::print("Parsing ByteBuffer'd packet of size: {}\n", pkt->size());
+template<typename Packet> void serverParser(Packet& pkt) {
+   std::print("Parsing ByteBuffer'd packet of size: {}\n", pkt.size());
 
    // Read the first 2 bytes (short) of the packet to determine the opcode
    short opcode = 0;
-   opcode = pkt->getShort();
+   opcode = pkt.getShort();
 
    // Switch based off the opcode to handle the specific packet
    switch(opcode) {
@@ -121,15 +167,15 @@ void serverParser(ByteBuffer* pkt) {
          uint8_t *username;
          uint8_t *password;
 
-         version = pkt->getInt();
+         version = pkt.getInt();
 
-         usize = pkt->getInt();
+         usize = pkt.getInt();
          username = new uint8_t[usize];
-         pkt->getBytes(username, usize);
+         pkt.getBytes(username, usize);
 
-         psize = pkt->getInt();
+         psize = pkt.getInt();
          password = new uint8_t[psize];
-         pkt->getBytes(password, psize);
+         pkt.getBytes(password, psize);
 
          std::print("Client Version: {}, Username: {} Password: {}\n", version, (const char*)username, (const char*)password);
 
@@ -144,13 +190,13 @@ void serverParser(ByteBuffer* pkt) {
          uint8_t *name;
          uint8_t *msg;
 
-         usize = pkt->getInt();
+         usize = pkt.getInt();
          name = new uint8_t[usize];
-         pkt->getBytes(name, usize);
+         pkt.getBytes(name, usize);
 
-         msize = pkt->getInt();
+         msize = pkt.getInt();
          msg = new uint8_t[msize];
-         pkt->getBytes(msg, msize);
+         pkt.getBytes(msg, msize);
 
          std::print("Name: {} Msg: {}\n", (const char*)name, (const char*)msg);
 
@@ -158,6 +204,14 @@ void serverParser(ByteBuffer* pkt) {
          delete [] msg;
          }
          break;
+      case Opcode(MOVE): {
+         std::print("Received a Move packet. Information: \n");
+
+         MoveBody move = pkt.template get<MoveBody>();
+
+         std::print("Player: {} Position: ({}, {}, {})\n", move.playerId, move.x, move.y, move.z);
+         }
+         break;
       default:
          std::print("Unknown Opcode: 0x{:x}\n", opcode);
          break;
@@ -243,16 +297,14 @@ int32_t main() {
       //                   + 4 (psize)  + 8 (password+null) = 28 bytes
       const uint32_t expectedSize = 28;
 
-      ByteBuffer* loginPkt = createLoginPacket(version, username, password);
+      auto loginPkt = createLoginPacket(version, username, password);
 
       check(loginPkt->size() == expectedSize, "login packet: wire size is correct");
 
-      serverParser(loginPkt); // display
+      serverParser(*loginPkt); // display
       check(loginPkt->bytesRemaining() == 0, "login packet: all bytes consumed by parser");
-      check(verifyLoginPacket(loginPkt, version, username, password),
+      check(verifyLoginPacket(loginPkt.get(), version, username, password),
             "login packet: opcode, version, username, password all verified");
-
-      delete loginPkt;
    }
 
    // --- Chat message packet ---
@@ -264,16 +316,71 @@ int32_t main() {
       //                   + 4 (msize)  + 13 (msg+null) = 29 bytes
       const uint32_t expectedSize = 29;
 
-      ByteBuffer* msgPkt = createChatMsgPacket(name, msg);
+      auto msgPkt = createChatMsgPacket(name, msg);
 
       check(msgPkt->size() == expectedSize, "chat packet: wire size is correct");
 
-      serverParser(msgPkt); // display
+      serverParser(*msgPkt); // display
       check(msgPkt->bytesRemaining() == 0, "chat packet: all bytes consumed by parser");
-      check(verifyChatMsgPacket(msgPkt, name, msg),
+      check(verifyChatMsgPacket(msgPkt.get(), name, msg),
             "chat packet: opcode, name, msg all verified");
+   }
+
+   // --- Move packet (struct serialization) ---
+   std::print("== Move packet ==\n");
+   {
+      const MoveBody move{7, 1.0f, 2.5f, -4.0f};
+      auto movePkt = createMovePacket(move);
+      // Expected wire size: 2 (opcode) + 4 (playerId) + 3 * 4 (x, y, z) = 18 bytes
+      check(movePkt->size() == 18, "move packet: wire size is correct");
+
+      serverParser(*movePkt); // display
+      check(movePkt->bytesRemaining() == 0, "move packet: all bytes consumed by parser");
+
+      movePkt->setReadPos(2);
+      MoveBody back = movePkt->get<MoveBody>();
+      check(back.playerId == 7 && back.x == 1.0f && back.y == 2.5f && back.z == -4.0f,
+            "move packet: playerId and position verified");
+   }
+
+   // --- Small packets stored inline ---
+   std::print("== Inline login packet ==\n");
+   {
+      // No upstream resource: any heap allocation would throw
+      FixedByteBuffer<64> pkt(std::pmr::null_memory_resource());
+      writeLoginPacket(pkt.buffer(), 3, "user", "pass");
+      check(pkt.size() == 24 && pkt.isInline(), "inline login packet: built without allocating");
+      check(verifyLoginPacket(&pkt.buffer(), 3, "user", "pass"), "inline login packet verified");
+   }
+
+   // --- Packet buffers are recycled ---
+   std::print("== Pooled packet buffers ==\n");
+   {
+      const uint8_t* firstStorage = nullptr;
+      {
+         auto pkt = createLoginPacket(1, "first", "pwd");
+         firstStorage = pkt->data();
+      } // lease released, buffer back in the pool
+      auto pkt = createLoginPacket(2, "second", "pwd");
+      check(pkt->data() == firstStorage, "pooled packets: next login packet reuses the released buffer");
+      // 2 (opcode) + 4 (version) + 4 (usize) + 7 (username+null) + 4 (psize) + 4 (password+null)
+      check(pkt->size() == 25, "pooled packets: recycled buffer starts out empty");
+      check(verifyLoginPacket(pkt.get(), 2, "second", "pwd"), "pooled packets: recycled login packet verified");
+   }
+
+   // --- Parsing straight from a receive buffer ---
+   std::print("== Receive buffer view ==\n");
+   {
+      auto loginPkt = createLoginPacket(42, "viewer", "nocopy");
+
+      // Stand-in for the memory a socket recv() just filled
+      auto recvBuf = make_unique<uint8_t[]>(loginPkt->size());
+      std::memcpy(recvBuf.get(), loginPkt->data(), loginPkt->size());
 
-      delete msgPkt;
+      ByteBufferView view(recvBuf.get(), loginPkt->size());
+      serverParser(view);
+      check(view.bytesRemaining() == 0, "receive buffer view: all bytes consumed by parser");
+      check(view.data() == recvBuf.get(), "receive buffer view: parsed in place, no copy");
    }
 
    // --- Unknown opcode ---
@@ -283,7 +390,7 @@ int32_t main() {
       unknownPkt.putShort(Opcode(UNKNOWN));
       unknownPkt.putInt(0xDEADBEEF);
       // serverParser should hit the default case and not crash
-      serverParser(&unknownPkt);
+      serverParser(unknownPkt);
       check(unknownPkt.bytesRemaining() == 4, // only the short was consumed
             "unknown opcode: only opcode bytes consumed by parser");
    }
@@ -16,13 +16,35 @@
  limitations under the License.
  */
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstdio>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
 #include <memory>
+#include <memory_resource>
 #include <print>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "ByteBuffer.hpp"
+#include "ByteBufferChain.hpp"
+#include "ByteBufferPool.hpp"
+#include "ByteBufferView.hpp"
+#include "ConstByteBuffer.hpp"
+#include "FixedByteBuffer.hpp"
+#include "MappedByteBuffer.hpp"
+#include "RingByteBuffer.hpp"
+#include "StreamByteReader.hpp"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 #ifdef BB_USE_NS
 using namespace bb;
@@ -37,6 +59,10 @@ static void check(bool cond, std::string_view msg) {
     }
 }
 
+// True if T can hand out a ByteBuffer that shares its storage
+template<typename T> concept HandsOutSharedCopies =
+    requires(const T& b) { b.clone(); } || requires(const T& b) { b.duplicate(); } || requires(const T& b) { b.slice(0, 1); };
+
 int32_t main() {
 
     // --- Primitive round-trips ---
@@ -143,6 +169,36 @@ int32_t main() {
         check(bb->find<uint8_t>(0xDEu, 1) == -1, "find 0xDE from pos 1: not found");
         // On little-endian: bytes [0xBA, 0xBE] at index 2 = uint16_t 0xBEBA
         check(bb->find<uint16_t>(0xBEBAu) == 2,  "find uint16_t 0xBEBA at index 2");
+
+        // Zero bytes are ordinary data, not a terminator
+        auto bin = std::make_unique<ByteBuffer>();
+        const uint8_t payload[] = {0x01, 0x00, 0x00, 0x7F, 0x00, 0x42};
+        bin->putBytes(payload, sizeof(payload));
+        check(bin->find<uint8_t>(0x42u) == 5, "find past embedded zeroes");
+        check(bin->find<uint8_t>(0x00u, 3) == 4, "find zero byte from pos 3");
+
+        // Multi-byte patterns, long enough to exercise the vector kernels and the scalar tail
+        auto big = std::make_unique<ByteBuffer>();
+        for (uint32_t i = 0; i < 1000; i++)
+            big->put(static_cast<uint8_t>('a' + (i % 7)));
+        const uint8_t needle[] = {'X', 'Y', 'Z', 'X', 'Y'};
+        big->putBytes(needle, sizeof(needle), 777);
+        check(big->findBytes(needle, sizeof(needle)) == 777, "findBytes 5 byte pattern at 777");
+        check(big->findBytes(needle, sizeof(needle), 778) == -1, "findBytes from past the match: not found");
+        big->putBytes(needle, sizeof(needle), 995);
+        check(big->findBytes(needle, sizeof(needle), 778) == 995, "findBytes match ending at the last byte");
+        const uint8_t xy[] = {'X', 'Y'};
+        check(big->findBytes(xy, 2, 779) == 780, "findBytes overlapping prefix");
+
+        // Line ends: CR or LF, found across vector blocks and in the scalar tail
+        check(big->findEol() == -1, "findEol: no line end");
+        big->put('\n', 40);
+        big->put('\r', 70);
+        big->put('\n', 998);
+        check(big->findEol() == 40 && big->findEol(41) == 70 && big->findEol(71) == 998, "findEol finds CR and LF");
+        check(big->findEol(999) == -1, "findEol past the last line end");
+        ByteBufferView eolView(*big);
+        check(eolView.findEol(50) == 70, "view findEol");
     }
 
     // --- replace ---
@@ -162,6 +218,28 @@ int32_t main() {
         bb->replace(0xFFu, 0x11u, 0, true); // first occurrence only
         check(bb->get(0) == 0x11u, "firstOccurrenceOnly: index 0 replaced");
         check(bb->get(2) == 0xFFu, "firstOccurrenceOnly: index 2 untouched");
+
+        // Zero bytes don't stop the replacement, and the vector body and scalar tail both apply
+        auto big = std::make_unique<ByteBuffer>();
+        for (uint32_t i = 0; i < 100; i++)
+            big->put(static_cast<uint8_t>(i % 4)); // 0, 1, 2, 3, 0, 1, ...
+        big->replace(0x02u, 0xEEu);
+        check(big->find<uint8_t>(0x02u) == -1, "replace all over zeroes: no key left");
+        check(big->get(98) == 0xEEu && big->get(99) == 0x03u, "replace all reaches the tail");
+
+        const uint8_t keys[] = {0x00, 0x03};
+        big->replaceAny(keys, 0x20u);
+        check(big->get(0) == 0x20u && big->get(1) == 0x01u && big->get(3) == 0x20u, "replaceAny over a key set");
+        check(big->find<uint8_t>(0x00u) == -1 && big->find<uint8_t>(0x03u) == -1, "replaceAny leaves no keys");
+
+        std::array<uint8_t, 256> upper;
+        for (uint32_t b = 0; b < upper.size(); b++)
+            upper[b] = (b >= 'a' && b <= 'z') ? static_cast<uint8_t>(b - 32) : static_cast<uint8_t>(b);
+        auto text = std::make_unique<ByteBuffer>();
+        const std::string hello = "Hello, translate table!";
+        text->putBytes(reinterpret_cast<const uint8_t*>(hello.data()), hello.size());
+        text->translate(upper, 7);
+        check(std::memcmp(text->data(), "Hello, TRANSLATE TABLE!", hello.size()) == 0, "translate from index 7");
     }
 
     // --- clone and equals ---
@@ -182,6 +260,73 @@ int32_t main() {
         check(empty->equals(emptyClone.get()), "clone of empty buffer equals original");
     }
 
+    // --- Copy-on-write clone, duplicate and slice ---
+    std::print("== copy-on-write clone/slice ==\n");
+    {
+        auto bb = std::make_unique<ByteBuffer>();
+        bb->putInt(0x11223344u);
+        bb->putInt(0x55667788u);
+        bb->getShort();
+
+        auto cloned = bb->clone();
+        check(cloned->data() == bb->data(),   "clone shares the backing bytes");
+        check(bb->isShared(),                 "original reports shared storage");
+        check(cloned->getReadPos() == 2 && cloned->getWritePos() == 8, "clone keeps rpos and wpos");
+
+        cloned->putInt(0xAABBCCDDu, 0);
+        check(cloned->data() != bb->data(),   "first write to the clone copies");
+        check(bb->getInt(0) == 0x11223344u,   "original unchanged after clone write");
+        check(cloned->getInt(4) == 0x55667788u, "clone keeps the rest of the contents after copying");
+        check(!bb->isShared(),                "original no longer shared after clone detached");
+
+        auto dup = bb->duplicate();
+        bb->put(0x01u, 7);
+        check(dup->get(7) == 0x55u && bb->get(7) == 0x01u, "write to original leaves duplicate unchanged");
+
+        auto slice = bb->slice(4, 4);
+        check(slice->size() == 4,                   "slice size");
+        check(slice->data() == bb->data() + 4,      "slice shares the backing bytes");
+        check(slice->getInt() == bb->getInt(4),     "slice reads from the offset");
+        auto clamped = bb->slice(6, 100);
+        check(clamped->size() == 2,                 "slice clamped to the end of the buffer");
+        slice->putShort(0xFFFFu, 0);
+        check(slice->getShort(0) == 0xFFFFu && bb->getShort(4) != 0xFFFFu, "slice write is private");
+        slice->putInt(0x12345678u, 4);
+        check(slice->size() == 8,                   "slice can grow after detaching");
+    }
+
+    // --- Hashing ---
+    std::print("== hash64 / crc32c ==\n");
+    {
+        auto bb = std::make_unique<ByteBuffer>();
+        check(bb->hash64() == 0xEF46DB3751D8E999ULL, "hash64 of empty buffer matches xxHash64");
+        const std::string digits = "123456789";
+        bb->putBytes(reinterpret_cast<const uint8_t*>(digits.data()), digits.size());
+        check(bb->crc32c() == 0xE3069283u, "crc32c check value of \"123456789\"");
+        check(bb->crc32c(4, 5, bb->crc32c(0, 4)) == bb->crc32c(), "crc32c continued over two ranges");
+
+        auto abc = std::make_unique<ByteBuffer>();
+        abc->putBytes(reinterpret_cast<const uint8_t*>("abc"), 3);
+        check(abc->hash64() == 0x44BC2CF5AD770999ULL, "hash64 of \"abc\" matches xxHash64");
+
+        // Long enough to go through the 32 byte stripe loop
+        auto a = std::make_unique<ByteBuffer>();
+        for (uint32_t i = 0; i < 100; i++)
+            a->put(static_cast<uint8_t>(i));
+        auto b = a->clone();
+        b->setReadPos(10);
+        check(a->hash64() == b->hash64(), "hash64 ignores read/write positions");
+        check(a->hash64(50, 50) != a->hash64(0, 50), "hash64 over different ranges differs");
+        b->put(0xFFu, 99);
+        check(a->hash64() != b->hash64(), "hash64 changes with contents");
+        check(!(*a == *b), "operator== after modifying clone");
+
+        std::unordered_map<ByteBuffer, int32_t> cache;
+        cache[*a] = 1;
+        auto c = a->clone();
+        check(cache.count(*c) == 1 && cache.count(*b) == 0, "ByteBuffer as unordered_map key");
+    }
+
     // --- resize ---
     std::print("== resize ==\n");
     {
@@ -224,6 +369,638 @@ int32_t main() {
         check(dst->get()   == 0x01u, "dst byte 0 == 0x01");
         check(dst->get()   == 0x02u, "dst byte 1 == 0x02");
         check(dst->get()   == 0x03u, "dst byte 2 == 0x03");
+
+        // Bulk range append, including appending a buffer to itself
+        dst->put(*src, 1, 100);
+        check(dst->size() == 5 && dst->get(3) == 0x02u && dst->get(4) == 0x03u, "put(src, offset, len) clamped to src");
+        dst->put(*dst, 0, 5);
+        check(dst->size() == 10 && dst->get(5) == 0x01u && dst->get(9) == 0x03u, "put of a buffer into itself");
+
+        // Only the unread bytes are appended, and src's read position is left alone
+        src->getShort();
+        auto tail = std::make_unique<ByteBuffer>();
+        tail->put(src.get());
+        check(tail->size() == 1 && tail->get(0) == 0x03u && src->getReadPos() == 2, "put(src) appends src's readable region");
+        src->get();
+        tail->put(src.get());
+        check(tail->size() == 1, "put(src) of a fully read buffer appends nothing");
+    }
+
+    // --- splice ---
+    std::print("== splice ==\n");
+    {
+        auto src = std::make_unique<ByteBuffer>();
+        src->putInt(0xAAAAAAAAu);
+        src->putInt(0x12345678u);
+        src->getInt(); // first int already consumed
+        const uint8_t* srcBytes = src->data();
+
+        auto empty = std::make_unique<ByteBuffer>();
+        empty->splice(*src);
+        check(empty->size() == 4 && empty->getInt() == 0x12345678u, "splice moves the unread region");
+        check(empty->data() == srcBytes + 4, "splice into an empty buffer doesn't copy");
+        check(src->size() == 0 && src->bytesRemaining() == 0, "splice leaves the source empty");
+
+        empty->putShort(0xBEEFu);
+        check(empty->size() == 6 && empty->getShort(4) == 0xBEEFu, "append after splice");
+        check(empty->getInt(0) == 0x12345678u, "spliced bytes kept after growing");
+
+        auto more = std::make_unique<ByteBuffer>();
+        more->put(0x01u);
+        more->put(0x02u);
+        empty->splice(*more);
+        check(empty->size() == 8 && empty->get(6) == 0x01u && empty->get(7) == 0x02u, "splice onto a non-empty buffer");
+    }
+
+    // --- Memory resources ---
+    std::print("== memory resource ==\n");
+    {
+        std::array<std::byte, 4096> arena;
+        std::pmr::monotonic_buffer_resource mr(arena.data(), arena.size(), std::pmr::null_memory_resource());
+        auto bb = std::make_unique<ByteBuffer>(64, &mr);
+        check(bb->getMemoryResource() == &mr, "getMemoryResource returns the resource passed in");
+        check(std::make_unique<ByteBuffer>()->getMemoryResource() == std::pmr::get_default_resource(), "default resource used when none given");
+
+        // The arena has no upstream, so any allocation outside it would throw
+        bb->putLong(0x0102030405060708ULL);
+        bb->putInt(0xDEADBEEFu);
+        const auto* arenaBegin = reinterpret_cast<const uint8_t*>(arena.data());
+        check(bb->data() >= arenaBegin && bb->data() < arenaBegin + arena.size(), "storage allocated from the arena");
+        check(bb->getLong(0) == 0x0102030405060708ULL && bb->getInt(8) == 0xDEADBEEFu, "read back from arena-backed buffer");
+
+        auto cl = bb->clone();
+        cl->putInt(0x11111111u, 0); // copy-on-write copy comes from the same resource
+        check(cl->getMemoryResource() == &mr, "clone keeps the memory resource");
+        check(cl->data() >= arenaBegin && cl->data() < arenaBegin + arena.size(), "clone's private copy allocated from the arena");
+        check(bb->getInt(0) != 0x11111111u, "original unaffected by write to clone");
+
+        bb->clear();
+        check(bb->getMemoryResource() == &mr, "clear keeps the memory resource");
+        auto moved = std::make_unique<ByteBuffer>(std::move(*cl));
+        check(moved->getMemoryResource() == &mr && moved->getInt(0) == 0x11111111u, "move keeps the memory resource");
+    }
+
+    // --- Buffer pool ---
+    std::print("== ByteBufferPool ==\n");
+    {
+        ByteBufferPool pool;
+        const uint8_t* storage = nullptr;
+        {
+            auto lease = pool.acquire(100);
+            check(lease->capacity() >= 100 && lease->size() == 0, "acquire returns an empty buffer with the requested room");
+            lease->putLong(0x0102030405060708ULL);
+            storage = lease->data();
+        }
+        check(pool.idleCount() == 1 && pool.retainedBytes() >= 100, "released lease returns its buffer to the pool");
+
+        auto again = pool.acquire(120); // same 128 byte class
+        check(again->data() == storage, "buffer reused for the same capacity class");
+        check(pool.idleCount() == 0 && pool.retainedBytes() == 0, "reused buffer leaves the pool");
+        check(again->size() == 0 && again->getWritePos() == 0 && again->getReadPos() == 0, "recycled buffer was cleared");
+
+        auto big = pool.acquire(4000); // different class, new buffer
+        check(big->capacity() >= 4000 && big.get() != again.get(), "larger class gets its own buffer");
+        again.reset();
+        big.reset();
+        check(pool.idleCount() == 2, "both buffers pooled");
+
+        pool.setMaxRetained(1024);
+        check(pool.retainedBytes() <= 1024 && pool.idleCount() == 1, "lowering the high-water mark trims the largest buffers first");
+        pool.trim();
+        check(pool.idleCount() == 0 && pool.retainedBytes() == 0, "trim() frees every idle buffer");
+
+        check(&ByteBufferPool::local() == &ByteBufferPool::local(), "local() returns the same pool on one thread");
+    }
+
+    // --- prepare / commit ---
+    std::print("== prepare / commit ==\n");
+    {
+        auto bb = std::make_unique<ByteBuffer>();
+        bb->putShort(0xBEEFu);
+        auto space = bb->prepare(64);
+        check(space.size() == 64 && space.data() == bb->data() + 2, "prepare returns space at the write position");
+        check(bb->size() == 2, "prepare doesn't change size()");
+
+        // Stand-in for recv() filling part of the prepared space
+        const uint8_t payload[] = {0x11, 0x22, 0x33, 0x44, 0x55};
+        std::memcpy(space.data(), payload, sizeof(payload));
+        bb->commit(sizeof(payload));
+        check(bb->size() == 7 && bb->getWritePos() == 7, "commit grows size() and advances wpos");
+        check(bb->get(2) == 0x11u && bb->get(6) == 0x55u, "committed bytes readable");
+
+        bb->putInt(0xDEADBEEFu);
+        check(bb->size() == 11 && bb->getInt(7) == 0xDEADBEEFu, "normal writes continue after commit");
+
+        bb->prepare(4);
+        bb->commit(100);
+        check(bb->size() == 15, "commit clamped to the prepared space");
+
+        auto cl = bb->clone();
+        auto cspace = cl->prepare(8);
+        check(cl->data() != bb->data() && cspace.data() == cl->data() + 15, "prepare on a shared buffer copies first");
+        cspace[0] = 0x77u;
+        cl->commit(1);
+        check(cl->get(15) == 0x77u && bb->size() == 15, "commit on a clone leaves the original alone");
+
+        // Gaps are still zero-filled even though growth no longer is
+        auto gap = std::make_unique<ByteBuffer>(4);
+        gap->put(0xFFu, 16);
+        bool zeroed = true;
+        for (uint32_t i = 0; i < 16; i++)
+            zeroed = zeroed && gap->get(i) == 0;
+        check(zeroed, "bytes skipped by an absolute write are zero");
+        gap->resize(32);
+        check(gap->size() == 32 && gap->get(16) == 0xFFu && gap->getInt(20) == 0, "resize zero-fills");
+    }
+
+#ifndef _WIN32
+    // --- Memory-mapped files ---
+    std::print("== MappedByteBuffer ==\n");
+    {
+        const std::string path = (std::filesystem::temp_directory_path() / "bb_mapped_test.bin").string();
+        {
+            auto bb = std::make_unique<ByteBuffer>();
+            bb->putInt(0xDEADBEEFu);
+            bb->putLong(0x0102030405060708ULL);
+            bb->putBytes((const uint8_t*)"needle", 6);
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write((const char*)bb->data(), bb->size());
+        }
+
+        auto ro = MappedByteBuffer::open(path);
+        check(ro != nullptr && ro->size() == 18, "open maps the whole file");
+        check(!ro->isWritable(), "default mode is read-only");
+        check(ro->advise(MappedByteBuffer::Advice::Sequential), "madvise sequential accepted");
+        check(ro->getInt() == 0xDEADBEEFu && ro->getLong() == 0x0102030405060708ULL, "get from mapped file");
+        check(ro->find('n') == 12 && ro->findBytes((const uint8_t*)"needle", 6) == 12, "find in mapped file");
+        ro->putInt(0x11111111u, 0);
+        check(ro->getInt(0) == 0xDEADBEEFu, "puts dropped on a read-only mapping");
+        check(!ro->sync(), "sync fails on a read-only mapping");
+        check(ro->data() == nullptr, "no writable pointer into a read-only mapping");
+        const uint8_t* roBytes = std::as_const(*ro).data();
+        check(roBytes != nullptr, "const data() is the read-only mapping address");
+        ByteBufferView roView(roBytes, ro->size());
+        check(roView.getInt(0) == 0xDEADBEEFu && std::memcmp(roBytes + 12, "needle", 6) == 0,
+              "read-only mapping read through data()");
+        ro.reset();
+
+        auto rw = MappedByteBuffer::open(path, MappedByteBuffer::Mode::ReadWrite);
+        check(rw != nullptr && rw->isWritable(), "open read-write");
+        check(rw->data() != nullptr && rw->data() == std::as_const(*rw).data(), "read-write data() is the mapping address");
+        rw->putInt(0xCAFEBABEu, 0);
+        rw->putInt(0x22222222u, 16); // Past the end of the file, dropped
+        check(rw->sync(), "msync succeeds");
+        rw.reset();
+
+        auto again = MappedByteBuffer::open(path);
+        check(again->getInt(0) == 0xCAFEBABEu && again->size() == 18, "changes written back to the file");
+        check(MappedByteBuffer::open(path + ".missing") == nullptr, "open of a missing file returns nullptr");
+        again.reset();
+        std::filesystem::remove(path);
+    }
+#endif
+
+    // --- Streaming reader ---
+    std::print("== StreamByteReader ==\n");
+    {
+        auto src = std::make_unique<ByteBuffer>();
+        for (uint32_t i = 0; i < 100; i++)
+            src->putInt(i);
+        src->putShort(0xBEEFu);
+
+        // Source hands out at most 3 bytes per call, so values straddle refills
+        auto trickle = [&src](void* buf, size_t len) -> size_t {
+            uint32_t n = std::min<size_t>({len, 3, src->bytesRemaining()});
+            src->getBytes((uint8_t*)buf, n);
+            return n;
+        };
+        StreamByteReader reader(trickle, 16);
+        check(reader.windowSize() == 16, "window size");
+
+        bool ordered = true;
+        for (uint32_t i = 0; i < 50; i++)
+            ordered = ordered && reader.getInt() == i;
+        check(ordered && reader.ok(), "getInt across refills");
+        check(reader.position() == 200, "position counts consumed bytes");
+
+        uint8_t big[40 * 4];
+        reader.getBytes(big, sizeof(big)); // Larger than the window
+        uint32_t v50 = 0, v89 = 0;
+        std::memcpy(&v50, big, 4);
+        std::memcpy(&v89, big + 39 * 4, 4);
+        check(v50 == 50 && v89 == 89 && reader.ok(), "getBytes larger than the window");
+
+        reader.skip(9 * 4);
+        check(reader.getInt() == 99, "skip");
+        check(reader.getShort() == 0xBEEFu && reader.ok(), "last value read");
+        check(reader.eof(), "eof after the last byte");
+        check(reader.getInt() == 0 && !reader.ok(), "read past the end returns 0 and clears ok()");
+        reader.clearError();
+        check(reader.ok(), "clearError");
+    }
+
+#ifndef _WIN32
+    {
+        int fds[2];
+        check(pipe(fds) == 0, "pipe");
+        const uint8_t bytes[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A};
+        check(write(fds[1], bytes, sizeof(bytes)) == sizeof(bytes), "write to pipe");
+        close(fds[1]);
+
+        StreamByteReader reader(fds[0], 8);
+        check(reader.get() == 0x01u && reader.getLong<std::endian::big>() == 0x0203040506070809ULL, "read from a file descriptor");
+        check(reader.get() == 0x0Au && reader.eof(), "fd reader reaches eof");
+        close(fds[0]);
+    }
+#endif
+
+    // --- compact / flip / mark ---
+    std::print("== compact / flip / mark ==\n");
+    {
+        auto bb = std::make_unique<ByteBuffer>(64);
+        bb->putInt(0x11111111u);
+        bb->putInt(0x22222222u);
+        bb->putInt(0x33333333u);
+        bb->getInt(); // first message consumed
+        bb->compact();
+        check(bb->size() == 8 && bb->getReadPos() == 0 && bb->getWritePos() == 8, "compact keeps only unread bytes");
+        check(bb->getInt(0) == 0x22222222u && bb->getInt(4) == 0x33333333u, "compact moves unread bytes to the front");
+        check(bb->capacity() >= 64, "compact keeps the reservation");
+        bb->putInt(0x44444444u);
+        check(bb->size() == 12 && bb->getInt(8) == 0x44444444u, "append after compact");
+
+        auto cl = bb->clone();
+        cl->getInt();
+        cl->compact();
+        check(cl->size() == 8 && cl->getInt(0) == 0x33333333u && bb->getInt(0) == 0x22222222u, "compact of a shared buffer");
+
+        bb->getInt();
+        bb->mark();
+        check(bb->getInt() == 0x33333333u, "read after mark");
+        bb->reset();
+        check(bb->getReadPos() == 4 && bb->getInt() == 0x33333333u, "reset returns to the mark");
+        bb->rewind();
+        check(bb->getReadPos() == 0, "rewind");
+
+        auto fl = std::make_unique<ByteBuffer>();
+        fl->resize(32);
+        fl->putShort(0xBEEFu);
+        fl->getShort();
+        fl->flip();
+        check(fl->size() == 2 && fl->getReadPos() == 0 && fl->getShort() == 0xBEEFu, "flip truncates to wpos and rewinds");
+    }
+
+    // --- Ring buffer ---
+    std::print("== RingByteBuffer ==\n");
+    {
+        RingByteBuffer ring(10);
+        check(ring.capacity() == 16 && ring.empty(), "capacity rounded up to a power of two");
+        constexpr bb_size_t maxCap = RingByteBuffer::MAX_CAPACITY;
+        static_assert(std::has_single_bit(maxCap) && maxCap > std::numeric_limits<bb_size_t>::max() / 2,
+                      "largest power of two in bb_size_t");
+        static_assert(RingByteBuffer::capacityFor(0) == 8 && RingByteBuffer::capacityFor(9) == 16, "small capacities");
+        static_assert(RingByteBuffer::capacityFor(maxCap) == maxCap && RingByteBuffer::capacityFor(maxCap - 1) == maxCap,
+                      "capacities up to the largest power of two round up");
+        static_assert(RingByteBuffer::capacityFor(maxCap + 1) == maxCap &&
+                      RingByteBuffer::capacityFor(std::numeric_limits<bb_size_t>::max()) == maxCap,
+                      "capacities past it are clamped instead of overflowing bit_ceil()");
+
+        ring.putLong(0x0102030405060708ULL);
+        ring.putInt(0xDEADBEEFu);
+        check(ring.bytesRemaining() == 12 && ring.bytesFree() == 4, "byte counts after puts");
+        check(ring.getLong() == 0x0102030405060708ULL, "getLong");
+
+        ring.putLong(0x1112131415161718ULL); // wraps around the end of the storage
+        check(ring.getInt() == 0xDEADBEEFu && ring.getLong() == 0x1112131415161718ULL, "values that wrap read back intact");
+
+        ring.putInt<BB_NETWORK_ORDER>(0xAABBCCDDu);
+        auto spans = ring.data();
+        check(spans[0].size() + spans[1].size() == 4, "data() covers the readable bytes");
+        uint8_t first = spans[0].empty() ? spans[1][0] : spans[0][0];
+        check(first == 0xAAu, "data() starts at the oldest byte");
+        ring.consume(4);
+        check(ring.empty(), "consume");
+
+        // Fill through prepare/commit in two pieces
+        auto space = ring.prepare();
+        check(space[0].size() + space[1].size() == 16, "prepare covers the free space");
+        uint8_t n = 0;
+        for (auto& sp : space)
+            for (auto& b : sp)
+                b = n++;
+        ring.commit(16);
+        ring.putInt(0x12345678u);
+        check(ring.bytesRemaining() == 16, "put on a full ring is dropped");
+
+        uint8_t out[20] = {};
+        check(ring.peek(out, 4, 2) == 4 && out[0] == 2 && out[3] == 5, "peek at an offset");
+        check(ring.read(out, 20) == 16 && out[15] == 15, "read is clamped to what's available");
+        check(ring.getInt() == 0 && ring.empty(), "get on an empty ring returns 0");
+        check(ring.write(out, 20) == 16, "write is clamped to the free space");
+    }
+
+#ifndef _WIN32
+    // --- Scatter/gather ---
+    std::print("== scatter/gather ==\n");
+    {
+        auto head = std::make_unique<ByteBuffer>();
+        head->putInt(0xAAAAAAAAu);
+        head->putInt(0x11223344u);
+        head->getInt(); // already sent
+        iovec one[2];
+        check(head->getReadableIov(one) == 1 && one[0].iov_base == head->data() + 4 && one[0].iov_len == 4,
+              "getReadableIov describes the unread bytes");
+
+        const uint8_t body[] = {'b', 'o', 'd', 'y'};
+        ByteBufferChain chain;
+        chain.append(*head);
+        chain.append(std::span<const uint8_t>(body));
+        head->putInt(0x55667788u, 4); // Copy-on-write: the chain keeps what was appended
+        check(chain.iovecs().size() == 2 && chain.totalBytes() == 8, "chain collects one iovec per piece");
+
+        ByteBufferChain framed;
+        for (int i = 0; i < 40; i++) {
+            char sep[8];
+            const int n = std::snprintf(sep, sizeof(sep), "<%d>", i);
+            framed.appendCopy(std::span((const uint8_t*)sep, n)); // sep goes out of scope: the chain keeps a copy
+            framed.append(std::span<const uint8_t>(body));
+        }
+        const std::vector<uint8_t> big(300, 'x');
+        framed.appendCopy(big);
+        std::string framedBytes;
+        for (const iovec& v : framed.iovecs())
+            framedBytes.append((const char*)v.iov_base, v.iov_len);
+        check(framedBytes.starts_with("<0>body<1>body") && framedBytes.find("<39>body") != std::string::npos &&
+              framedBytes.ends_with(std::string(300, 'x')) && framed.iovecs().size() == 81,
+              "appendCopy keeps copies of small and large pieces");
+
+        int fds[2];
+        check(pipe(fds) == 0, "pipe");
+        check(chain.writev(fds[1]) == 8 && chain.empty(), "writev sends the whole chain");
+
+        auto a = std::make_unique<ByteBuffer>();
+        auto b = std::make_unique<ByteBuffer>();
+        ByteBuffer* bufs[] = {a.get(), b.get()};
+        check(ByteBufferChain::readv(fds[0], bufs, 6) == 8, "readv into two buffers");
+        check(a->size() == 6 && b->size() == 2, "readv fills the buffers in order");
+        check(a->getInt() == 0x11223344u && a->getChar() == 'b' && a->getChar() == 'o', "first buffer contents");
+        check(b->getChar() == 'd' && b->getChar() == 'y', "second buffer contents");
+        close(fds[0]);
+        close(fds[1]);
+
+        chain.append(std::span<const uint8_t>(body));
+        chain.append(std::span<const uint8_t>(body));
+        chain.consume(5);
+        check(chain.iovecs().size() == 1 && chain.iovecs()[0].iov_len == 3 && chain.totalBytes() == 3, "consume after a partial write");
+    }
+#endif
+
+    // --- Bulk arrays ---
+    std::print("== putArray / getArray ==\n");
+    {
+        std::vector<uint32_t> samples(1000);
+        for (uint32_t i = 0; i < samples.size(); i++)
+            samples[i] = i * 0x01010101u;
+
+        auto bb = std::make_unique<ByteBuffer>(16);
+        bb->putArray<uint32_t>(samples);
+        check(bb->size() == 4000 && bb->getWritePos() == 4000, "putArray writes every element");
+        check(bb->getInt(4 * 7) == samples[7], "putArray native order");
+
+        std::vector<uint32_t> back(1000);
+        bb->getArray<uint32_t>(back);
+        check(back == samples && bb->getReadPos() == 4000, "getArray round trip");
+
+        auto be = std::make_unique<ByteBuffer>();
+        const uint16_t shorts[] = {0x0102, 0x0304, 0x0506, 0x0708, 0x090A, 0x0B0C, 0x0D0E, 0x0F10, 0x1112, 0x1314};
+        be->putArray<uint16_t, std::endian::big>(shorts);
+        check(be->get(0) == 0x01u && be->get(1) == 0x02u && be->get(18) == 0x13u, "putArray big endian");
+        be->putArray<uint64_t, std::endian::big>(std::vector<uint64_t>(5, 0x0102030405060708ULL));
+        check(be->get(20) == 0x01u && be->get(27) == 0x08u && be->getLong<std::endian::big>(20 + 32) == 0x0102030405060708ULL,
+              "putArray 64-bit big endian");
+
+        uint16_t shortsBack[10];
+        be->getArray<uint16_t, std::endian::big>(shortsBack);
+        check(std::memcmp(shortsBack, shorts, sizeof(shorts)) == 0, "getArray big endian");
+
+        std::vector<double> doubles(3);
+        be->setReadPos(be->size() - 8);
+        be->getArray<double>(doubles);
+        check(be->getReadPos() == be->size() - 8, "getArray reads nothing when too few bytes remain");
+
+        // Long enough for the vector path plus a tail
+        std::vector<uint32_t> many(37);
+        for (uint32_t i = 0; i < many.size(); i++)
+            many[i] = 0x11223344u + i;
+        auto nb = std::make_unique<ByteBuffer>();
+        nb->putArray<uint32_t, BB_NETWORK_ORDER>(many);
+        bool swapped = true;
+        for (uint32_t i = 0; i < many.size(); i++)
+            swapped = swapped && nb->getInt<BB_NETWORK_ORDER>(i * 4) == many[i];
+        check(swapped, "putArray network order matches putInt network order");
+    }
+
+    // --- Struct serialization ---
+    std::print("== put(obj) / get<T>() ==\n");
+    {
+        struct Vec3 {
+            float x, y, z;
+        };
+        enum class Kind : uint16_t { Ping = 1, Move = 2 };
+        struct Header { // padded: 2 + 4 bytes encoded, 8 in memory
+            Kind kind;
+            uint32_t seq;
+        };
+        struct Move {
+            Header hdr;
+            Vec3 pos;
+            std::array<uint16_t, 3> flags;
+            uint8_t last;
+        };
+
+        static_assert(bb_reflect::fieldCount<Move>() == 4, "Move has 4 fields");
+        static_assert(bb_reflect::encodedSize<Header>() == 6, "padding isn't encoded");
+        static_assert(bb_reflect::encodedSize<Move>() == 6 + 12 + 6 + 1, "exact encoded size");
+        static_assert(bb_reflect::isFlat<Vec3>() && !bb_reflect::isFlat<Header>(), "flat detection");
+
+        const Move m{{Kind::Move, 77}, {1.5f, -2.0f, 3.25f}, {{1, 2, 3}}, 0xEE};
+        auto bb = std::make_unique<ByteBuffer>();
+        bb->put(m);
+        check(bb->size() == 25, "put(obj) writes the encoded size");
+        check(bb->getShort(0) == 2 && bb->getInt(2) == 77 && bb->getFloat(6) == 1.5f && bb->get(24) == 0xEEu,
+              "fields written in order without padding");
+
+        Move back = bb->get<Move>();
+        check(back.hdr.kind == Kind::Move && back.hdr.seq == 77 && back.pos.z == 3.25f && back.flags[2] == 3 && back.last == 0xEE,
+              "get<T>() round trip");
+        check(bb->getReadPos() == 25, "get<T>() advances the read position");
+        Move none = bb->get<Move>();
+        check(none.hdr.seq == 0 && bb->getReadPos() == 25, "get<T>() past the end returns T{}");
+
+        auto net = std::make_unique<ByteBuffer>();
+        net->put<BB_NETWORK_ORDER>(m);
+        check(net->getShort<BB_NETWORK_ORDER>(0) == 2 && net->getInt<BB_NETWORK_ORDER>(2) == 77, "put<E>(obj) converts each field");
+        Move netBack = net->get<Move, BB_NETWORK_ORDER>();
+        check(netBack.pos.y == -2.0f && netBack.flags[1] == 2, "get<T, E>() round trip");
+
+        ByteBufferView view(*net);
+        view.setReadPos(0);
+        check(view.get<Move, BB_NETWORK_ORDER>().hdr.seq == 77, "view get<T>()");
+
+        // Existing overloads still win for plain values
+        bb->clear();
+        bb->put(0x01u);
+        check(bb->size() == 1, "put(uint8_t) unaffected");
+    }
+
+    // --- Sticky error state and read windows ---
+    std::print("== ok() / require() ==\n");
+    {
+        auto bb = std::make_unique<ByteBuffer>();
+        bb->putInt(7);
+        bb->putShort(9);
+        check(bb->ok(), "new buffer is ok");
+        check(bb->getInt() == 7 && bb->getShort() == 9 && bb->ok(), "in-bounds reads stay ok");
+        check(bb->peek() == 0 && bb->ok(), "peek at the end is not an error");
+        check(bb->getLong() == 0 && !bb->ok(), "reading past the end sets the error");
+        bb->setReadPos(0);
+        check(bb->getInt() == 7 && !bb->ok(), "error is sticky across later good reads");
+        bb->clearError();
+        check(bb->ok(), "clearError() resets it");
+        uint8_t out[16];
+        bb->getBytes(out, sizeof(out));
+        check(!bb->ok() && bb->getReadPos() == 4, "short getBytes sets the error without reading");
+        bb->clear();
+        check(bb->ok(), "clear() resets the error");
+
+        bb->putShort<BB_NETWORK_ORDER>(0x0102);
+        bb->putInt(0xCAFEBABEu);
+        bb->put(0x7Fu);
+        if (auto w = bb->require(7)) {
+            check(w.bytesRemaining() == 7, "window covers the required bytes");
+            check(w.getShort<BB_NETWORK_ORDER>() == 0x0102 && w.getInt() == 0xCAFEBABEu, "unchecked window reads");
+            check(bb->getReadPos() == 0, "read position moves when the window closes");
+        } else {
+            check(false, "require() within bounds succeeds");
+        }
+        check(bb->getReadPos() == 6 && bb->get() == 0x7Fu, "only the bytes read through the window are consumed");
+        {
+            auto w = bb->require(1);
+            check(!w && !bb->ok() && bb->getReadPos() == 7, "require() past the end fails and sets the error");
+        }
+
+        const uint8_t raw[] = {1, 0, 0, 0, 2};
+        ByteBufferView view(raw, sizeof(raw));
+        if (auto w = view.require(5)) {
+            check(w.getInt() == 1 && w.get() == 2, "view window reads");
+        }
+        check(view.getReadPos() == 5 && view.ok(), "view window consumed");
+        view.getShort();
+        check(!view.ok(), "view read past the end sets the error");
+
+        uint8_t small[2];
+        MutableByteBufferView mview(small, sizeof(small));
+        mview.putInt(1);
+        check(!mview.ok(), "dropped write sets the error");
+
+        RingByteBuffer ring(8);
+        ring.putShort(0);
+        check(ring.getShort() == 0 && ring.ok(), "ring: a real zero is ok");
+        ring.putShort(0x0102);
+        check(ring.getInt() == 0 && !ring.ok() && ring.bytesRemaining() == 2, "ring: short typed get sets the error");
+        check(ring.getShort() == 0x0102 && !ring.ok(), "ring: error is sticky");
+        ring.clearError();
+        ring.put(9);
+        ring.putLong(1);
+        check(!ring.ok() && ring.bytesRemaining() == 1, "ring: put that doesn't fit sets the error");
+        ring.clear();
+        check(ring.ok(), "ring: clear() resets the error");
+
+#ifndef BB_64BIT_SIZES
+        // A write ending past what a 32-bit size can index is dropped instead of truncating size()
+        auto edge = std::make_unique<ByteBuffer>();
+        edge->putInt(5);
+        edge->putInt(0xAABBCCDDu, 0xFFFFFFFEu);
+        const uint64_t big = 1;
+        edge->putBytes((const uint8_t*)&big, sizeof(big), 0xFFFFFFFCu);
+        check(!edge->ok() && edge->size() == 4 && edge->getInt(0) == 5, "write past 4 GiB dropped and sets the error");
+        edge->clearError();
+        edge->setWritePos(0xFFFFFFF0u);
+        check(edge->prepare(0x20).empty() && !edge->ok(), "prepare() past 4 GiB returns no space");
+#endif
+    }
+
+    // --- Inline small-buffer storage ---
+    std::print("== FixedByteBuffer ==\n");
+    {
+        FixedByteBuffer<32> fb(std::pmr::null_memory_resource());
+        static_assert(FixedByteBuffer<32>::inlineCapacity() == 32, "inline capacity");
+        check(fb.isInline() && fb.size() == 0, "starts empty and inline");
+        for (uint32_t i = 0; i < 8; i++)
+            fb.putInt(i);
+        check(fb.isInline() && fb.size() == 32, "N bytes fit without allocating");
+        check(fb.getInt(28) == 7 && fb.getInt() == 0, "reads back like a ByteBuffer");
+
+        FixedByteBuffer<16> spill;
+        for (uint32_t i = 0; i < 16; i++)
+            spill.putInt(i);
+        check(!spill.isInline() && spill.size() == 64 && spill.getInt(60) == 15, "spills to the heap past N");
+
+        const uint8_t raw[] = {1, 2, 3};
+        FixedByteBuffer<8> fromArr(raw, sizeof(raw));
+        ByteBuffer& asBase = fromArr.buffer();
+        check(asBase.size() == 3 && asBase.get(2) == 3 && fromArr.isInline(), "usable through buffer()");
+        static_assert(!std::is_convertible_v<FixedByteBuffer<8>&, ByteBuffer&> &&
+                      !std::is_constructible_v<ByteBuffer, FixedByteBuffer<8>&&> &&
+                      !std::is_constructible_v<ByteBuffer, const FixedByteBuffer<8>&>,
+                      "no ByteBuffer can be copied or moved out of a FixedByteBuffer's inline bytes");
+        static_assert(HandsOutSharedCopies<ByteBuffer> && !HandsOutSharedCopies<FixedByteBuffer<8>>,
+                      "sharing copies aren't part of FixedByteBuffer's API");
+
+        // A deep copy outlives the FixedByteBuffer and its inline bytes
+        ByteBuffer keep;
+        {
+            FixedByteBuffer<16> scoped;
+            scoped.putInt(0xFEEDF00Du);
+            scoped.putInt(42);
+            scoped.getInt();
+            keep = scoped.toByteBuffer();
+        }
+        check(keep.size() == 8 && keep.getReadPos() == 4 && keep.getInt(0) == 0xFEEDF00Du, "toByteBuffer() copy outlives the source");
+        keep.putInt(7);
+        check(keep.getInt() == 42 && keep.getInt() == 7 && keep.getMemoryResource() == std::pmr::get_default_resource(),
+              "toByteBuffer() copy grows on its own resource");
+    }
+
+    // --- Compile-time byte sequences ---
+    std::print("== ConstByteBuffer ==\n");
+    {
+        static constexpr auto hello = [] {
+            ConstByteBuffer<32> b;
+            b.putShort<BB_NETWORK_ORDER>(0x0102);
+            b.putInt<std::endian::little>(0xAABBCCDDu);
+            b.putFloat<BB_NETWORK_ORDER>(1.0f);
+            b.putString("HI");
+            b.putLine("x");
+            return b;
+        }();
+        static_assert(hello.ok() && hello.size() == 2 + 4 + 4 + 2 + 3, "built at compile time");
+        static_assert(hello[0] == 0x01 && hello[1] == 0x02 && hello[2] == 0xDD && hello[6] == 0x3F, "byte order applied");
+        static constexpr auto exact = hello.toArray<hello.size()>();
+        static_assert(exact.size() == 15 && exact[14] == '\n', "exactly-sized array");
+
+        constexpr auto tooSmall = [] {
+            ConstByteBuffer<3> b;
+            b.putInt(1);
+            return b;
+        }();
+        static_assert(!tooSmall.ok() && tooSmall.size() == 0, "write that doesn't fit is dropped");
+
+        auto bb = std::make_unique<ByteBuffer>();
+        bb->putBytes(hello.data(), hello.size());
+        check(bb->getShort<BB_NETWORK_ORDER>() == 0x0102 && bb->getInt<std::endian::little>() == 0xAABBCCDDu &&
+              bb->getFloat<BB_NETWORK_ORDER>() == 1.0f, "compile-time bytes read back at runtime");
+        check(hello.str().ends_with("HIx\r\n"), "text and CRLF");
     }
 
     // --- Read/write position management ---
@@ -257,6 +1034,59 @@ int32_t main() {
         check(bb->get(16)   == 0xFFu, "byte at index 16 == 0xFF");
     }
 
+    // --- ByteBufferView / MutableByteBufferView ---
+    std::print("== ByteBufferView ==\n");
+    {
+        uint8_t raw[16] = {};
+        MutableByteBufferView wview(raw, sizeof(raw));
+        wview.putShort(0xBEEFu);
+        wview.putInt(0xDEADBEEFu);
+        wview.putLong(0x0102030405060708ULL);
+        check(wview.getWritePos() == 14, "mutable view wpos 14 after writes");
+        wview.putInt(0x11223344u); // would run past the end of raw
+        check(wview.getWritePos() == 14, "mutable view drops writes past the end");
+
+        ByteBufferView view(raw, sizeof(raw));
+        check(view.data() == raw,              "view borrows the array, no copy");
+        check(view.getShort() == 0xBEEFu,      "view getShort");
+        check(view.getInt()   == 0xDEADBEEFu,  "view getInt");
+        check(view.getLong()  == 0x0102030405060708ULL, "view getLong");
+        check(view.bytesRemaining() == 2,      "view bytesRemaining 2");
+        check(view.getInt() == 0,              "view read past end returns 0");
+        check(view.getShort(0) == 0xBEEFu,     "view absolute getShort");
+
+        auto bb = std::make_unique<ByteBuffer>();
+        bb->putInt(0xCAFEBABEu);
+        bb->putShort(0x1234u);
+        bb->getInt();
+        ByteBufferView bbView(*bb);
+        check(bbView.getReadPos() == 4,        "ByteBuffer view starts at the buffer's rpos");
+        check(bbView.getShort() == 0x1234u,    "ByteBuffer view reads the buffer's contents");
+    }
+
+    // --- Explicit byte order ---
+    std::print("== Explicit byte order ==\n");
+    {
+        auto bb = std::make_unique<ByteBuffer>();
+        bb->putShort<std::endian::big>(0x1234u);
+        bb->putInt<std::endian::big>(0xDEADBEEFu);
+        bb->putLong<std::endian::little>(0x0102030405060708ULL);
+        bb->putFloat<BB_NETWORK_ORDER>(3.14f);
+        check(bb->get(0) == 0x12u && bb->get(1) == 0x34u, "big endian short is MSB first");
+        check(bb->get(2) == 0xDEu && bb->get(5) == 0xEFu, "big endian int is MSB first");
+        check(bb->get(6) == 0x08u && bb->get(13) == 0x01u, "little endian long is LSB first");
+
+        check(bb->getShort<std::endian::big>()   == 0x1234u,     "getShort<big> round-trip");
+        check(bb->getInt<std::endian::big>()     == 0xDEADBEEFu, "getInt<big> round-trip");
+        check(bb->getLong<std::endian::little>() == 0x0102030405060708ULL, "getLong<little> round-trip");
+        check(bb->getFloat<BB_NETWORK_ORDER>()   == 3.14f,       "getFloat<network> round-trip");
+        check(bb->getInt<std::endian::big>(2)    == 0xDEADBEEFu, "absolute getInt<big>");
+
+        ByteBufferView view(*bb);
+        check(view.getShort<std::endian::big>(0) == 0x1234u, "view getShort<big>");
+        static_assert(endianConvert<std::endian::native>(0x1234u) == 0x1234u, "native order is a no-op");
+    }
+
     if (failures == 0) {
         std::print("\nAll tests PASSED\n");
         return 0;